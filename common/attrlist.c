@@ -131,7 +131,7 @@ static struct attr *attrDelete(uiprivAttrList *alist, struct attr *a)
 
 	next = attrUnlink(alist, a);
 	uiprivAttributeRelease(a->val);
-	uiprivFree(a);
+	uiprivPoolDelete(struct attr, a);
 	return next;
 }
 
@@ -179,7 +179,7 @@ static struct attr *attrDropRange(uiprivAttrList *alist, struct attr *a, size_t
 	}
 
 	// we'll need to split the attribute into two
-	b = uiprivNew(struct attr);
+	b = uiprivPoolNew(struct attr);
 	b->val = uiprivAttributeRetain(a->val);
 	b->start = end;
 	b->end = a->end;
@@ -223,7 +223,7 @@ static struct attr *attrSplitAt(uiprivAttrList *alist, struct attr *a, size_t at
 	if (at >= a->end)
 		return NULL;
 
-	b = uiprivNew(struct attr);
+	b = uiprivPoolNew(struct attr);
 	b->val = uiprivAttributeRetain(a->val);
 	b->start = at;
 	b->end = a->end;
@@ -300,7 +300,7 @@ void uiprivFreeAttrList(uiprivAttrList *alist)
 	while (a != NULL) {
 		next = a->next;
 		uiprivAttributeRelease(a->val);
-		uiprivFree(a);
+		uiprivPoolDelete(struct attr, a);
 		a = next;
 	}
 	uiprivFree(alist);
@@ -353,7 +353,7 @@ void uiprivAttrListInsertAttribute(uiprivAttrList *alist, uiAttribute *val, size
 	}
 
 	// if we got here, we know we have to add the attribute before before
-	a = uiprivNew(struct attr);
+	a = uiprivPoolNew(struct attr);
 	a->val = uiprivAttributeRetain(val);
 	a->start = start;
 	a->end = end;
@@ -106,7 +106,7 @@ void uiAttributedStringAppendUnattributed(uiAttributedString *s, const char *str
 	uiAttributedStringInsertAtUnattributed(s, str, s->len);
 }
 
-// this works (and returns true, which is what we want) at s->len too because s->s[s->len] is always going to be 0 due to us allocating s->len + 1 bytes and because uiprivRealloc() always zero-fills allocated memory
+// this works (and returns true, which is what we want) at s->len too because s->s[s->len] is always going to be 0 due to us allocating s->len + 1 bytes and always null-terminating
 static int onCodepointBoundary(uiAttributedString *s, size_t at)
 {
 	uint8_t c;
@@ -152,6 +152,9 @@ void uiAttributedStringInsertAtUnattributed(uiAttributedString *s, const char *s
 	oldlen = s->len;
 	old16len = s->u16len;
 	resize(s, s->len + n8, s->u16len + n16);
+	// uiprivRealloc() doesn't necessarily zero-fill, so terminate the strings ourselves
+	s->s[s->len] = 0;
+	s->u16[s->u16len] = 0;
 
 	// move existing characters out of the way
 	// note the use of memmove(): https://twitter.com/rob_pike/status/737797688217894912
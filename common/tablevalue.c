@@ -22,7 +22,7 @@ static uiTableValue *newTableValue(uiTableValueType type)
 {
 	uiTableValue *v;
 
-	v = uiprivNew(uiTableValue);
+	v = uiprivPoolNew(uiTableValue);
 	v->type = type;
 	return v;
 }
@@ -34,7 +34,7 @@ void uiFreeTableValue(uiTableValue *v)
 		uiprivFree(v->u.str);
 		break;
 	}
-	uiprivFree(v);
+	uiprivPoolDelete(uiTableValue, v);
 }
 
 uiTableValueType uiTableValueGetType(const uiTableValue *v)
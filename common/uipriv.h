@@ -13,10 +13,18 @@ extern "C" {
 extern uiInitOptions uiprivOptions;
 
 // OS-specific alloc.* files
+// on Unix these can be called from any thread; the other platforms still expect the main thread
+// uiprivAlloc() always zero-fills the new memory, but uiprivRealloc() need not zero-fill the part that a resize adds, so clear that yourself if you need it to be
 extern void *uiprivAlloc(size_t, const char *);
 #define uiprivNew(T) ((T *) uiprivAlloc(sizeof (T), #T))
 extern void *uiprivRealloc(void *, size_t, const char *);
 extern void uiprivFree(void *);
+// small objects that are created and destroyed in bulk come from fixed-size pools where the OS-specific allocator has them
+// uiprivPoolFree() needs the same size the object was allocated with, so always pair uiprivPoolNew() with uiprivPoolDelete() and never mix these with uiprivRealloc() or uiprivFree()
+extern void *uiprivPoolAlloc(size_t, const char *);
+#define uiprivPoolNew(T) ((T *) uiprivPoolAlloc(sizeof (T), #T))
+extern void uiprivPoolFree(void *, size_t);
+#define uiprivPoolDelete(T, p) uiprivPoolFree((p), sizeof (T))
 
 // debug.c and OS-specific debug.* files
 // TODO get rid of this mess...
@@ -33,6 +33,12 @@ struct uiArea {
 	uiAreaHandler *ah;
 	BOOL scrolling;
 	NSEvent *dragevent;
+
+	// for uiAreaOnFrame()
+	int (*onFrame)(uiArea *, double, double, void *);
+	void *onFrameData;
+	uiTimerID frameTimer;
+	int frames;
 };
 
 @implementation areaView
@@ -54,6 +60,7 @@ struct uiArea {
 	uiArea *a = self->libui_a;
 	CGContextRef c;
 	uiAreaDrawParams dp;
+	uiAreaRect damage;
 
 	c = (CGContextRef) [[NSGraphicsContext currentContext] graphicsPort];
 	// see draw.m under text for why we need the height
@@ -70,6 +77,13 @@ struct uiArea {
 	dp.ClipY = r.origin.y;
 	dp.ClipWidth = r.size.width;
 	dp.ClipHeight = r.size.height;
+	// TODO pass the individual rectangles from -getRectsBeingDrawn:count: like the Unix version does
+	damage.X = dp.ClipX;
+	damage.Y = dp.ClipY;
+	damage.Width = dp.ClipWidth;
+	damage.Height = dp.ClipHeight;
+	dp.DamageRects = &damage;
+	dp.NumDamageRects = 1;
 
 	// no need to save or restore the graphics state to reset transformations; Cocoa creates a brand-new context each time
 	(*(a->ah->Draw))(a->ah, a, &dp);
@@ -364,6 +378,7 @@ static void uiAreaDestroy(uiControl *c)
 {
 	uiArea *a = uiArea(c);
 
+	uiAreaOnFrame(a, NULL, NULL);
 	if (a->scrolling)
 		uiprivScrollViewFreeData(a->sv, a->d);
 	[a->area release];
@@ -420,6 +435,50 @@ void uiAreaQueueRedrawAll(uiArea *a)
 	[a->area setNeedsDisplay:YES];
 }
 
+// TODO redraw only the rectangles like the Unix version does
+void uiAreaQueueRedrawRect(uiArea *a, double x, double y, double width, double height)
+{
+	uiAreaQueueRedrawAll(a);
+}
+
+void uiAreaQueueRedrawRects(uiArea *a, const uiAreaRect *rects, int n)
+{
+	uiAreaQueueRedrawAll(a);
+}
+
+// TODO drive this from the display's refresh like the Unix version does
+static int areaFrame(void *data)
+{
+	uiArea *a = (uiArea *) data;
+	uiTimerID timer;
+	double t;
+
+	timer = a->frameTimer;
+	t = (double) (a->frames++) * (1000.0 / 60);
+	if ((*(a->onFrame))(a, t, t, a->onFrameData))
+		// if the callback called uiAreaOnFrame() itself, this timer is no longer the area's
+		return a->frameTimer == timer;
+	if (a->frameTimer == timer) {
+		a->frameTimer = 0;
+		a->onFrame = NULL;
+		a->onFrameData = NULL;
+	}
+	return 0;
+}
+
+void uiAreaOnFrame(uiArea *a, int (*f)(uiArea *a, double frameTime, double presentationTime, void *data), void *data)
+{
+	if (a->frameTimer != 0)
+		uiTimerCancel(a->frameTimer);
+	a->frameTimer = 0;
+	a->onFrame = f;
+	a->onFrameData = data;
+	if (f == NULL)
+		return;
+	a->frames = 0;
+	a->frameTimer = uiTimerStart(1000.0 / 60, uiTimerModeFixedRate, areaFrame, a);
+}
+
 void uiAreaScrollTo(uiArea *a, double x, double y, double width, double height)
 {
 	if (!a->scrolling)
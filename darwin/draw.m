@@ -99,6 +99,45 @@ void uiDrawPathAddRectangle(uiDrawPath *p, double x, double y, double width, dou
 	CGPathAddRect(p->path, NULL, CGRectMake(x, y, width, height));
 }
 
+// TODO feed these to Core Graphics in bulk like the Unix version does
+
+void uiDrawPathAddPolyline(uiDrawPath *p, const double *xy, int n)
+{
+	int i;
+
+	if (n <= 0)
+		return;
+	uiDrawPathNewFigure(p, xy[0], xy[1]);
+	for (i = 1; i < n; i++)
+		uiDrawPathLineTo(p, xy[2 * i], xy[2 * i + 1]);
+}
+
+void uiDrawPathAddPolygon(uiDrawPath *p, const double *xy, int n)
+{
+	if (n <= 0)
+		return;
+	uiDrawPathAddPolyline(p, xy, n);
+	uiDrawPathCloseFigure(p);
+}
+
+void uiDrawPathAddRectangles(uiDrawPath *p, const double *xywh, int n)
+{
+	int i;
+
+	for (i = 0; i < n; i++)
+		uiDrawPathAddRectangle(p, xywh[4 * i], xywh[4 * i + 1], xywh[4 * i + 2], xywh[4 * i + 3]);
+}
+
+void uiDrawPathAddCircles(uiDrawPath *p, const double *xyr, int n)
+{
+	int i;
+
+	for (i = 0; i < n; i++) {
+		uiDrawPathNewFigureWithArc(p, xyr[3 * i], xyr[3 * i + 1], xyr[3 * i + 2], 0, 2 * uiPi, 0);
+		uiDrawPathCloseFigure(p);
+	}
+}
+
 void uiDrawPathEnd(uiDrawPath *p)
 {
 	p->ended = TRUE;
@@ -109,6 +148,19 @@ int uiDrawPathEnded(uiDrawPath *p)
 	return p->ended == TRUE ? 1 : 0;
 }
 
+void uiDrawPathReset(uiDrawPath *p)
+{
+	// TODO keep the memory like the Unix version does; CGMutablePath can't be emptied in place
+	CGPathRelease((CGPathRef) (p->path));
+	p->path = CGPathCreateMutable();
+	p->ended = NO;
+}
+
+void uiDrawPathReserve(uiDrawPath *p, int n)
+{
+	// do nothing; CGMutablePath has no way to reserve space
+}
+
 uiDrawContext *uiprivDrawNewContext(CGContextRef ctxt, CGFloat height)
 {
 	uiDrawContext *c;
@@ -302,6 +354,41 @@ void uiDrawFill(uiDrawContext *c, uiDrawPath *path, uiDrawBrush *b)
 	uiprivUserBug("Unknown brush type %d passed to uiDrawFill().", b->Type);
 }
 
+// TODO cache the CGGradient like the Unix version does
+struct uiDrawCachedBrush {
+	uiDrawBrush b;
+};
+
+uiDrawCachedBrush *uiDrawNewCachedBrush(uiDrawBrush *b)
+{
+	uiDrawCachedBrush *cb;
+
+	cb = uiprivNew(uiDrawCachedBrush);
+	cb->b = *b;
+	if (b->NumStops != 0) {
+		cb->b.Stops = (uiDrawBrushGradientStop *) uiprivAlloc(b->NumStops * sizeof (uiDrawBrushGradientStop), "uiDrawBrushGradientStop[]");
+		memcpy(cb->b.Stops, b->Stops, b->NumStops * sizeof (uiDrawBrushGradientStop));
+	}
+	return cb;
+}
+
+void uiDrawFreeCachedBrush(uiDrawCachedBrush *cb)
+{
+	if (cb->b.NumStops != 0)
+		uiprivFree(cb->b.Stops);
+	uiprivFree(cb);
+}
+
+void uiDrawCachedBrushFill(uiDrawContext *c, uiDrawPath *path, uiDrawCachedBrush *cb)
+{
+	uiDrawFill(c, path, &(cb->b));
+}
+
+void uiDrawCachedBrushStroke(uiDrawContext *c, uiDrawPath *path, uiDrawCachedBrush *cb, uiDrawStrokeParams *p)
+{
+	uiDrawStroke(c, path, &(cb->b), p);
+}
+
 static void m2c(uiDrawMatrix *m, CGAffineTransform *c)
 {
 	c->a = m->M11;
@@ -454,3 +541,49 @@ void uiDrawRestore(uiDrawContext *c)
 {
 	CGContextRestoreGState(c->c);
 }
+
+// TODO test against the damage like the Unix version does
+int uiDrawIntersectsDamage(uiDrawContext *c, double x, double y, double width, double height)
+{
+	return 1;
+}
+
+// TODO keep layer contents like the Unix version does
+struct uiDrawLayer {
+	int unused;
+};
+
+uiDrawLayer *uiDrawNewLayer(double width, double height)
+{
+	return uiprivNew(uiDrawLayer);
+}
+
+void uiDrawFreeLayer(uiDrawLayer *l)
+{
+	uiprivFree(l);
+}
+
+int uiDrawLayerValid(uiDrawContext *c, uiDrawLayer *l)
+{
+	return 0;
+}
+
+void uiDrawLayerInvalidate(uiDrawLayer *l)
+{
+	// do nothing
+}
+
+void uiDrawLayerBegin(uiDrawContext *c, uiDrawLayer *l)
+{
+	// do nothing
+}
+
+void uiDrawLayerEnd(uiDrawContext *c, uiDrawLayer *l)
+{
+	// do nothing
+}
+
+void uiDrawLayerDraw(uiDrawContext *c, uiDrawLayer *l, uiDrawMatrix *m, double opacity)
+{
+	// do nothing
+}
@@ -145,6 +145,7 @@ void uiUninit(void)
 		uiprivUserBug("You must call uiInit() first!");
 	[globalPool release];
 
+	uiprivUninitWorkers();
 	@autoreleasepool {
 		uiprivUninitUnderlineColors();
 		[delegate release];
@@ -244,6 +245,18 @@ void uiQueueMain(void (*f)(void *data), void *data)
 	dispatch_async_f(dispatch_get_main_queue(), data, f);
 }
 
+// TODO map priorities onto the native message loop like the Unix version does
+void uiQueueMainWithPriority(uiQueuePriority priority, void (*f)(void *data), void *data)
+{
+	uiQueueMain(f, data);
+}
+
+// TODO coalesce calls with the same key like the Unix version does
+void uiQueueMainKeyed(const void *key, void (*f)(void *data), void *data, void (*freeData)(void *data))
+{
+	uiQueueMain(f, data);
+}
+
 @interface uiprivTimerDelegate : NSObject {
         int (*f)(void *data);
         void *data;
@@ -287,3 +300,257 @@ void uiTimer(int milliseconds, int (*f)(void *data), void *data)
 
 // TODO figure out the best way to clean the above up in uiUninit(), if it's even necessary
 // TODO that means figure out if timers can still fire without the main loop
+
+// TODO implement the fixed-rate modes and share one native timer like the Unix version does
+struct timerHandle {
+	uiTimerID id;
+	int (*f)(void *);
+	void *data;
+	int cancelled;
+	struct timerHandle *next;
+};
+
+static struct timerHandle *timerHandles = NULL;
+static uiTimerID nextTimerID = 1;
+
+static struct timerHandle *findTimerHandle(uiTimerID id)
+{
+	struct timerHandle *h;
+
+	for (h = timerHandles; h != NULL; h = h->next)
+		if (h->id == id && !h->cancelled)
+			return h;
+	return NULL;
+}
+
+static int timerHandleTick(void *data)
+{
+	struct timerHandle *h = (struct timerHandle *) data;
+	struct timerHandle **p;
+
+	if (!h->cancelled && !(*(h->f))(h->data))
+		h->cancelled = 1;
+	if (!h->cancelled)
+		return 1;
+	for (p = &timerHandles; *p != h; p = &((*p)->next))
+		;
+	*p = h->next;
+	free(h);
+	return 0;
+}
+
+// these are malloc()'d rather than uiprivNew()'d because a cancelled timer is only freed on its next tick, which might not come before uiUninit()
+static void startTimerHandle(uiTimerID id, double milliseconds, int (*f)(void *), void *data)
+{
+	struct timerHandle *h;
+
+	h = (struct timerHandle *) malloc(sizeof (struct timerHandle));
+	h->id = id;
+	h->f = f;
+	h->data = data;
+	h->cancelled = 0;
+	h->next = timerHandles;
+	timerHandles = h;
+	uiTimer((int) milliseconds, timerHandleTick, h);
+}
+
+uiTimerID uiTimerStart(double milliseconds, uiTimerMode mode, int (*f)(void *data), void *data)
+{
+	if (nextTimerID == 0)
+		nextTimerID++;
+	startTimerHandle(nextTimerID, milliseconds, f, data);
+	return nextTimerID++;
+}
+
+void uiTimerCancel(uiTimerID id)
+{
+	struct timerHandle *h;
+
+	h = findTimerHandle(id);
+	if (h != NULL)
+		h->cancelled = 1;
+}
+
+void uiTimerReschedule(uiTimerID id, double milliseconds)
+{
+	struct timerHandle *h;
+
+	h = findTimerHandle(id);
+	if (h == NULL)
+		return;
+	h->cancelled = 1;
+	startTimerHandle(id, milliseconds, h->f, h->data);
+}
+
+// TODO enforce a time budget like the Unix version does
+void uiScheduleWork(int (*f)(void *data), void *data)
+{
+	uiTimer(1, f, data);
+}
+
+void uiSchedulerSetBudget(int budgetMicroseconds, int periodMicroseconds)
+{
+	// do nothing
+}
+
+void uiSchedulerGetStats(uiSchedulerStats *stats)
+{
+	memset(stats, 0, sizeof (uiSchedulerStats));
+}
+
+// jobs run on a global concurrent dispatch queue, in a dispatch group so uiUninit() can wait for the ones that are running
+// unlike the Unix version, libdispatch has no per-thread deques for us to steal from; it balances the work itself
+// these are malloc()'d rather than uiprivNew()'d because they are freed on the dispatch queue's threads, and because a completion that is still queued when uiUninit() is called is never run, and so never frees what it holds
+// the counters and flags are only touched with the compiler's __atomic builtins
+
+struct uiCancelToken {
+	int refcount;
+	int cancelled;
+};
+
+struct workerJob {
+	uiCancelToken *t;
+	void (*work)(uiCancelToken *, void *);
+	void (*done)(int, void *);
+	void *data;
+};
+
+static dispatch_once_t workerGroupOnce;
+static dispatch_group_t workerGroup = NULL;
+static int queued = 0;
+static int quitting = 0;
+
+uiCancelToken *uiNewCancelToken(void)
+{
+	uiCancelToken *t;
+
+	t = (uiCancelToken *) malloc(sizeof (uiCancelToken));
+	t->refcount = 1;
+	t->cancelled = 0;
+	return t;
+}
+
+static void unrefToken(uiCancelToken *t)
+{
+	if (t != NULL && __atomic_sub_fetch(&(t->refcount), 1, __ATOMIC_ACQ_REL) == 0)
+		free(t);
+}
+
+void uiFreeCancelToken(uiCancelToken *t)
+{
+	// jobs that were submitted with the token keep it alive until they're done
+	unrefToken(t);
+}
+
+void uiCancelTokenCancel(uiCancelToken *t)
+{
+	__atomic_store_n(&(t->cancelled), 1, __ATOMIC_RELEASE);
+}
+
+int uiCancelTokenCancelled(uiCancelToken *t)
+{
+	if (t == NULL)
+		return 0;
+	return __atomic_load_n(&(t->cancelled), __ATOMIC_ACQUIRE);
+}
+
+static void freeJob(struct workerJob *j)
+{
+	unrefToken(j->t);
+	free(j);
+}
+
+static void workerRunDone(void *data)
+{
+	struct workerJob *j = (struct workerJob *) data;
+
+	// check the token here rather than on the worker, so that cancelling from the main thread after the work is done still counts
+	if (j->done != NULL)
+		(*(j->done))(uiCancelTokenCancelled(j->t), j->data);
+	freeJob(j);
+}
+
+static void workerRun(void *data)
+{
+	struct workerJob *j = (struct workerJob *) data;
+
+	__atomic_sub_fetch(&queued, 1, __ATOMIC_RELAXED);
+	// jobs that haven't started by uiUninit() are dropped without calling their completion callbacks, like on Unix
+	if (__atomic_load_n(&quitting, __ATOMIC_ACQUIRE)) {
+		freeJob(j);
+		return;
+	}
+	if (!uiCancelTokenCancelled(j->t))
+		(*(j->work))(j->t, j->data);
+	uiQueueMain(workerRunDone, j);
+}
+
+void uiWorkerSubmit(uiCancelToken *t, void (*work)(uiCancelToken *t, void *data), void (*done)(int cancelled, void *data), void *data)
+{
+	struct workerJob *j;
+
+	// the group outlives uiUninit(), since it's empty again once uiUninit() has waited on it
+	dispatch_once(&workerGroupOnce, ^{
+		workerGroup = dispatch_group_create();
+	});
+	j = (struct workerJob *) malloc(sizeof (struct workerJob));
+	j->t = t;
+	if (t != NULL)
+		__atomic_add_fetch(&(t->refcount), 1, __ATOMIC_RELAXED);
+	j->work = work;
+	j->done = done;
+	j->data = data;
+	__atomic_add_fetch(&queued, 1, __ATOMIC_RELAXED);
+	// the signature of workerRun() matches dispatch_function_t
+	dispatch_group_async_f(workerGroup, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), j, workerRun);
+}
+
+int uiWorkerQueueDepth(void)
+{
+	return __atomic_load_n(&queued, __ATOMIC_RELAXED);
+}
+
+// called by uiUninit(), before the main thread queue goes away
+void uiprivUninitWorkers(void)
+{
+	if (workerGroup == NULL)
+		return;
+	__atomic_store_n(&quitting, 1, __ATOMIC_RELEASE);
+	// jobs that are running are allowed to finish; the rest see quitting and free themselves
+	dispatch_group_wait(workerGroup, DISPATCH_TIME_FOREVER);
+	__atomic_store_n(&quitting, 0, __ATOMIC_RELEASE);
+}
+
+// TODO record latencies like the Unix version does
+void uiLatencyEnable(int enable)
+{
+	// do nothing
+}
+
+void uiLatencyGetHistogram(uiLatencyKind kind, uiLatencyHistogram *h)
+{
+	memset(h, 0, sizeof (uiLatencyHistogram));
+}
+
+void uiLatencyReset(void)
+{
+	// do nothing
+}
+
+void uiLatencyDump(void)
+{
+	// do nothing
+}
+
+// TODO watch the main loop like the Unix version does
+void uiWatchdogStart(int thresholdMilliseconds, void (*f)(const char *dispatch, double stalledMilliseconds, int ended, void *data), void *data)
+{
+	if (thresholdMilliseconds <= 0)
+		uiprivUserBug("Invalid threshold %d passed to uiWatchdogStart().", thresholdMilliseconds);
+	// otherwise do nothing
+}
+
+void uiWatchdogStop(void)
+{
+	// do nothing
+}
@@ -60,6 +60,7 @@ extern void uiprivUninitMenus(void);
 @interface uiprivAppDelegate : NSObject<NSApplicationDelegate>
 @property (strong) uiprivMenuManager *menuManager;
 @end
+extern void uiprivUninitWorkers(void);
 #define uiprivAppDelegate() ((uiprivAppDelegate *) [uiprivNSApp() delegate])
 typedef struct uiprivNextEventArgs uiprivNextEventArgs;
 struct uiprivNextEventArgs {
@@ -0,0 +1,66 @@
+#include <stdint.h>
+#include "bench.h"
+
+// uiTableValue is the cheapest public object that maps onto exactly one libui-internal allocation, which makes it a good probe for the cost of allocation tracking
+// we keep an increasing number of them alive and measure how long it takes to free them in a scattered order, as happens with real table models and attributed strings
+// with O(1) tracking, the cost per free should stay flat as the live count grows
+
+#define maxLive 1000000
+
+static uiTableValue **values;
+
+// walk the live set with a prime stride so frees are scattered across it without needing a shuffled copy
+// the stride has no factors in common with the powers of ten we use for the live count, so every value is visited exactly once
+#define stride 7919
+
+static void benchLive(size_t n)
+{
+	double start, allocTime, freeTime;
+	size_t i;
+
+	start = benchNow();
+	for (i = 0; i < n; i++)
+		values[i] = uiNewTableValueInt((int) i);
+	allocTime = benchNow() - start;
+
+	start = benchNow();
+	for (i = 0; i < n; i++)
+		uiFreeTableValue(values[(size_t) (((uint64_t) i * stride) % n)]);
+	freeTime = benchNow() - start;
+
+	printf("[ RESULT   ] live %8zu: %7.1f ns/alloc %7.1f ns/free\n",
+		n,
+		allocTime / (double) n * 1e9,
+		freeTime / (double) n * 1e9);
+}
+
+int allocRunBenchmarks(void)
+{
+	size_t n;
+	int i;
+	uiMemoryPoolStats s;
+
+	benchGroup("allocation tracking (uiNewTableValueInt()/uiFreeTableValue())");
+	values = (uiTableValue **) malloc(maxLive * sizeof (uiTableValue *));
+	if (values == NULL) {
+		fprintf(stderr, "out of memory\n");
+		return 1;
+	}
+	for (n = 1000; n <= maxLive; n *= 10)
+		benchLive(n);
+	free(values);
+
+	benchGroup("memory pools");
+	for (i = 0; i < uiMemoryNumPools(); i++) {
+		uiMemoryGetPoolStats(i, &s);
+		if (s.Allocations == 0)
+			continue;
+		printf("[ RESULT   ] %4zu-byte blocks: %9zu allocations, %5.1f%% reused, %zu live, %zu chunks\n",
+			s.BlockSize,
+			s.Allocations,
+			100.0 * (double) (s.Reused) / (double) (s.Allocations),
+			s.Live,
+			s.Chunks);
+	}
+	return 0;
+}
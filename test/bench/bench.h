@@ -0,0 +1,36 @@
+#ifndef __LIBUI_BENCH_H__
+#define __LIBUI_BENCH_H__
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "../../ui.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Benchmark run functions.
+ *
+ * Each one prints its own results table and returns nonzero on failure.
+ */
+int allocRunBenchmarks(void);
+int queueMainRunBenchmarks(void);
+int drawPathRunBenchmarks(void);
+
+/**
+ * Returns a monotonic timestamp in seconds.
+ */
+double benchNow(void);
+
+/**
+ * Prints the header line for a benchmark group.
+ */
+void benchGroup(const char *name);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
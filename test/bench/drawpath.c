@@ -0,0 +1,161 @@
+#include <gtk/gtk.h>
+#include "bench.h"
+#include "../../ui_unix.h"
+
+// a long polyline is stroked over and over, as happens when a plot is redrawn for hover effects
+// building the path and drawing it are timed separately, so the cost of replaying an ended path can be told apart from the cost of rasterizing it
+// the image is small and the line is thin, so rasterizing doesn't swamp everything else
+
+#define imageSize 64
+#define nDraws 20
+
+static uiDrawPath *buildPolyline(int n)
+{
+	uiDrawPath *path;
+	int i;
+
+	path = uiDrawNewPath(uiDrawFillModeWinding);
+	uiDrawPathNewFigure(path, 0, 0);
+	for (i = 1; i < n; i++)
+		uiDrawPathLineTo(path, (double) (i % imageSize), (double) ((i * 7) % imageSize));
+	uiDrawPathEnd(path);
+	return path;
+}
+
+static void benchPolyline(int n)
+{
+	uiUnixDrawImage *img;
+	uiDrawContext *c;
+	uiDrawPath *path;
+	uiDrawBrush brush = {0};
+	uiDrawStrokeParams sp = {0};
+	double start, buildTime, drawTime;
+	int i;
+
+	img = uiUnixNewDrawImage(imageSize, imageSize);
+	c = uiUnixDrawImageContext(img);
+	brush.Type = uiDrawBrushTypeSolid;
+	brush.A = 1.0;
+	sp.Cap = uiDrawLineCapFlat;
+	sp.Join = uiDrawLineJoinMiter;
+	sp.Thickness = 1;
+	sp.MiterLimit = uiDrawDefaultMiterLimit;
+
+	start = benchNow();
+	path = buildPolyline(n);
+	buildTime = benchNow() - start;
+
+	start = benchNow();
+	for (i = 0; i < nDraws; i++)
+		uiDrawStroke(c, path, &brush, &sp);
+	drawTime = (benchNow() - start) / nDraws;
+
+	printf("[ RESULT   ] %7d segments: build %8.2f ms (%5.1f ns/segment), stroke %8.2f ms (%5.1f ns/segment)\n",
+		n,
+		buildTime * 1e3, buildTime / (double) n * 1e9,
+		drawTime * 1e3, drawTime / (double) n * 1e9);
+
+	uiDrawFreePath(path);
+	uiUnixFreeDrawImage(img);
+}
+
+// a small path rebuilt every frame, as examples/histogram does, either as a new path each time or by resetting one
+#define nFrames 100000
+#define nFramePoints 20
+
+static void buildFrame(uiDrawPath *path)
+{
+	int i;
+
+	uiDrawPathNewFigure(path, 0, 0);
+	for (i = 1; i < nFramePoints; i++)
+		uiDrawPathLineTo(path, (double) i, (double) (i * i));
+	uiDrawPathEnd(path);
+}
+
+static void benchRebuild(void)
+{
+	uiDrawPath *path;
+	double start, newTime, resetTime;
+	int i;
+
+	start = benchNow();
+	for (i = 0; i < nFrames; i++) {
+		path = uiDrawNewPath(uiDrawFillModeWinding);
+		buildFrame(path);
+		uiDrawFreePath(path);
+	}
+	newTime = benchNow() - start;
+
+	path = uiDrawNewPath(uiDrawFillModeWinding);
+	uiDrawPathReserve(path, nFramePoints);
+	start = benchNow();
+	for (i = 0; i < nFrames; i++) {
+		uiDrawPathReset(path);
+		buildFrame(path);
+	}
+	resetTime = benchNow() - start;
+	uiDrawFreePath(path);
+
+	printf("[ RESULT   ] %d-point path per frame: new/free %6.1f ns/frame, reset %6.1f ns/frame\n",
+		nFramePoints,
+		newTime / nFrames * 1e9,
+		resetTime / nFrames * 1e9);
+}
+
+// a million-point plot, built with a call per point and then with one call for the whole array
+#define nPlotPoints 1000000
+
+static void benchBulk(void)
+{
+	double *xy;
+	uiDrawPath *path;
+	double start, perCallTime, bulkTime;
+	int i;
+
+	xy = (double *) malloc(2 * nPlotPoints * sizeof (double));
+	if (xy == NULL) {
+		fprintf(stderr, "out of memory\n");
+		return;
+	}
+	for (i = 0; i < nPlotPoints; i++) {
+		xy[2 * i] = (double) i;
+		xy[2 * i + 1] = (double) ((i * 7) % imageSize);
+	}
+
+	start = benchNow();
+	path = uiDrawNewPath(uiDrawFillModeWinding);
+	uiDrawPathNewFigure(path, xy[0], xy[1]);
+	for (i = 1; i < nPlotPoints; i++)
+		uiDrawPathLineTo(path, xy[2 * i], xy[2 * i + 1]);
+	uiDrawPathEnd(path);
+	perCallTime = benchNow() - start;
+	uiDrawFreePath(path);
+
+	start = benchNow();
+	path = uiDrawNewPath(uiDrawFillModeWinding);
+	uiDrawPathAddPolyline(path, xy, nPlotPoints);
+	uiDrawPathEnd(path);
+	bulkTime = benchNow() - start;
+	uiDrawFreePath(path);
+
+	printf("[ RESULT   ] %d points: uiDrawPathLineTo() %5.1f ns/point, uiDrawPathAddPolyline() %5.1f ns/point\n",
+		nPlotPoints,
+		perCallTime / nPlotPoints * 1e9,
+		bulkTime / nPlotPoints * 1e9);
+	free(xy);
+}
+
+int drawPathRunBenchmarks(void)
+{
+	int n;
+
+	benchGroup("uiDrawPath (build once, stroke repeatedly)");
+	for (n = 1000; n <= 100000; n *= 10)
+		benchPolyline(n);
+	benchGroup("uiDrawPath (rebuild every frame)");
+	benchRebuild();
+	benchGroup("uiDrawPath (bulk geometry)");
+	benchBulk();
+	return 0;
+}
@@ -0,0 +1,59 @@
+// clock_gettime() is POSIX, not C99
+#define _POSIX_C_SOURCE 200809L
+#include <time.h>
+
+#include "bench.h"
+
+double benchNow(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (double) (ts.tv_sec) + (double) (ts.tv_nsec) / 1e9;
+}
+
+void benchGroup(const char *name)
+{
+	printf("[----------] %s\n", name);
+}
+
+struct benchmark {
+	int (*fn)(void);
+	// the others don't need uiInit(), so they still run without a display
+	int needsInit;
+};
+
+int main(void)
+{
+	uiInitOptions o = {0};
+	const char *err;
+	int initialized;
+	size_t i;
+	int failed = 0;
+	struct benchmark benchmarks[] = {
+		{ allocRunBenchmarks, 0 },
+		{ queueMainRunBenchmarks, 1 },
+		{ drawPathRunBenchmarks, 0 },
+	};
+
+	err = uiInit(&o);
+	initialized = err == NULL;
+	if (!initialized) {
+		fprintf(stderr, "error initializing libui: %s\n", err);
+		fprintf(stderr, "running only the benchmarks that don't need uiInit()\n");
+		uiFreeInitError(err);
+	}
+
+	for (i = 0; i < sizeof (benchmarks) / sizeof (*benchmarks); i++) {
+		if (benchmarks[i].needsInit && !initialized) {
+			puts("[ SKIPPED  ] needs uiInit()");
+			continue;
+		}
+		failed += (benchmarks[i].fn)();
+	}
+
+	if (initialized)
+		uiUninit();
+	puts("[==========]");
+	return failed;
+}
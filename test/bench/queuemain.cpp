@@ -0,0 +1,87 @@
+#include <thread>
+#include <vector>
+#include <algorithm>
+#include "bench.h"
+
+// this follows the pattern of examples/cpp-multithread: worker threads hand results to the UI with uiQueueMain() while the main thread runs the main loop
+// each item carries the time it was posted, so we get both throughput and how long items wait before the main thread runs them
+
+struct item {
+	double posted;
+};
+
+static std::vector<double> latencies;
+static size_t received;
+
+static void onItem(void *data)
+{
+	item *it = (item *) data;
+
+	latencies.push_back(benchNow() - it->posted);
+	received++;
+}
+
+// if rate is 0, post as fast as possible; otherwise post rate items per second per producer
+static void producer(item *items, size_t n, double rate)
+{
+	double start;
+	size_t i;
+
+	start = benchNow();
+	for (i = 0; i < n; i++) {
+		if (rate != 0)
+			while (benchNow() - start < (double) i / rate)
+				std::this_thread::yield();
+		items[i].posted = benchNow();
+		uiQueueMain(onItem, &items[i]);
+	}
+}
+
+static double percentile(double p)
+{
+	size_t i;
+
+	i = (size_t) (p * (double) (latencies.size() - 1));
+	return latencies[i] * 1e6;
+}
+
+static void benchQueue(const char *name, int nProducers, size_t perProducer, double rate)
+{
+	std::vector<item> items(nProducers * perProducer);
+	std::vector<std::thread> threads;
+	size_t total;
+	double start, elapsed;
+	int i;
+
+	latencies.clear();
+	latencies.reserve(items.size());
+	received = 0;
+	total = items.size();
+
+	start = benchNow();
+	for (i = 0; i < nProducers; i++)
+		threads.push_back(std::thread(producer, &items[i * perProducer], perProducer, rate));
+	while (received < total)
+		uiMainStep(1);
+	elapsed = benchNow() - start;
+	for (auto &t : threads)
+		t.join();
+
+	std::sort(latencies.begin(), latencies.end());
+	printf("[ RESULT   ] %-28s %d thread(s): %9.0f items/s, latency p50 %8.1f us, p99 %8.1f us, max %8.1f us\n",
+		name, nProducers,
+		(double) total / elapsed,
+		percentile(0.50), percentile(0.99), percentile(1.0));
+}
+
+int queueMainRunBenchmarks(void)
+{
+	benchGroup("uiQueueMain() throughput and latency");
+	uiMainSteps();
+	benchQueue("burst", 1, 200000, 0);
+	benchQueue("burst", 4, 50000, 0);
+	// the kind of load a telemetry feed produces: 10k items per second in total
+	benchQueue("steady 10k/s", 1, 5000, 10000);
+	benchQueue("steady 10k/s", 4, 1250, 2500);
+	return 0;
+}
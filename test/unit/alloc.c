@@ -0,0 +1,157 @@
+#include <glib.h>
+#include "unit.h"
+
+// these test the Unix allocator through the table values, which are allocated from the pools; the other platforms don't pool memory yet
+
+#define nValues 100
+
+// the pools are shared by everything libui allocates, so tests look at how the totals change rather than at any one pool
+static void poolTotals(uiMemoryPoolStats *total)
+{
+	uiMemoryPoolStats s;
+	int i;
+
+	memset(total, 0, sizeof (uiMemoryPoolStats));
+	for (i = 0; i < uiMemoryNumPools(); i++) {
+		uiMemoryGetPoolStats(i, &s);
+		total->Allocations += s.Allocations;
+		total->Reused += s.Reused;
+		total->Live += s.Live;
+		total->Chunks += s.Chunks;
+	}
+}
+
+static void newValues(uiTableValue **v, int n)
+{
+	int i;
+
+	for (i = 0; i < n; i++)
+		v[i] = uiNewTableValueString("value");
+}
+
+static void freeValues(uiTableValue **v, int n)
+{
+	int i;
+
+	for (i = 0; i < n; i++)
+		uiFreeTableValue(v[i]);
+}
+
+static void allocPoolReuse(void **state)
+{
+	uiTableValue *v[nValues];
+	uiMemoryPoolStats before, during, after;
+
+	assert_true(uiMemoryNumPools() > 0);
+	poolTotals(&before);
+	newValues(v, nValues);
+	poolTotals(&during);
+	assert_int_equal(during.Allocations - before.Allocations, nValues);
+	assert_int_equal(during.Live - before.Live, nValues);
+	freeValues(v, nValues);
+	// the second round gets back the blocks the first round freed
+	newValues(v, nValues);
+	freeValues(v, nValues);
+	poolTotals(&after);
+	assert_int_equal(after.Allocations - before.Allocations, 2 * nValues);
+	assert_true(after.Reused - before.Reused >= nValues);
+	assert_int_equal(after.Live, before.Live);
+	// nothing new was needed for the second round
+	assert_int_equal(after.Chunks, during.Chunks);
+}
+
+static uiForEach findTableValueStats(const uiMemoryStats *s, void *data)
+{
+	if (strcmp(s->Type, "uiTableValue") != 0)
+		return uiForEachContinue;
+	*((uiMemoryStats *) data) = *s;
+	return uiForEachStop;
+}
+
+// returns 0 if uiTableValue has no statistics, which is the case when allocation tracking is disabled
+static int tableValueStats(uiMemoryStats *s)
+{
+	memset(s, 0, sizeof (uiMemoryStats));
+	uiMemoryStatsForEach(findTableValueStats, s);
+	return s->Type != NULL;
+}
+
+static void allocTypeStats(void **state)
+{
+	uiTableValue *v[nValues];
+	uiMemoryStats before, during, after;
+
+	// make sure the type has an entry to start with
+	newValues(v, 1);
+	freeValues(v, 1);
+	if (!tableValueStats(&before))
+		skip();
+	newValues(v, nValues);
+	assert_true(tableValueStats(&during));
+	assert_int_equal(during.LiveCount - before.LiveCount, nValues);
+	assert_int_equal(during.TotalAllocations - before.TotalAllocations, nValues);
+	assert_true(during.LiveBytes > before.LiveBytes);
+	assert_true(during.PeakBytes >= during.LiveBytes);
+	freeValues(v, nValues);
+	assert_true(tableValueStats(&after));
+	assert_int_equal(after.LiveCount, before.LiveCount);
+	assert_int_equal(after.LiveBytes, before.LiveBytes);
+	assert_int_equal(after.TotalAllocations, during.TotalAllocations);
+	// the high-water mark stays where it was
+	assert_int_equal(after.PeakBytes, during.PeakBytes);
+}
+
+#define nThreads 4
+#define nRounds 50
+
+// each thread allocates and frees values of its own, and leaves the last round for the main thread to free
+static gpointer allocOnThread(gpointer data)
+{
+	uiTableValue **kept = (uiTableValue **) data;
+	uiTableValue *v[nValues];
+	int i;
+
+	for (i = 0; i < nRounds; i++) {
+		newValues(v, nValues);
+		freeValues(v, nValues);
+	}
+	newValues(kept, nValues);
+	return NULL;
+}
+
+static void allocWorkerThreads(void **state)
+{
+	uiTableValue *kept[nThreads][nValues];
+	GThread *threads[nThreads];
+	uiMemoryPoolStats before, during, after;
+	int i;
+
+	poolTotals(&before);
+	for (i = 0; i < nThreads; i++)
+		threads[i] = g_thread_new("allocWorkerThreads", allocOnThread, kept[i]);
+	// the statistics can be read while other threads are using the pools
+	for (i = 0; i < 1000; i++)
+		poolTotals(&during);
+	for (i = 0; i < nThreads; i++)
+		g_thread_join(threads[i]);
+	// the threads have exited, so everything they counted is in the pools now
+	poolTotals(&during);
+	assert_int_equal(during.Allocations - before.Allocations, nThreads * (nRounds + 1) * nValues);
+	assert_int_equal(during.Live - before.Live, nThreads * nValues);
+	// blocks can be freed on a different thread than the one that allocated them
+	for (i = 0; i < nThreads; i++)
+		freeValues(kept[i], nValues);
+	poolTotals(&after);
+	assert_int_equal(after.Live, before.Live);
+}
+
+int allocRunUnitTests(void)
+{
+	const struct CMUnitTest tests[] = {
+		cmocka_unit_test_setup_teardown(allocPoolReuse, unitInitSetup, unitUninitTeardown),
+		cmocka_unit_test_setup_teardown(allocTypeStats, unitInitSetup, unitUninitTeardown),
+		cmocka_unit_test_setup_teardown(allocWorkerThreads, unitInitSetup, unitUninitTeardown),
+	};
+
+	return cmocka_run_group_tests_name("uiMemory", tests, NULL, NULL);
+}
@@ -0,0 +1,209 @@
+#include "unit.h"
+
+// these test that uiAreaQueueRedrawRects() redraws just the rectangles it's given, and that uiDrawIntersectsDamage() agrees with uiAreaDrawParams.DamageRects
+// only the Unix version passes more than the bounding box or ever returns FALSE from uiDrawIntersectsDamage() (see ui.h)
+
+struct damage {
+	uiAreaHandler ah;
+	int draws;
+	// set while a redraw queued by the test is expected
+	int checking;
+	int checked;
+	int nRects;
+	uiAreaRect bounds;
+	// what uiDrawIntersectsDamage() said about the probes in probes[]
+	int hits[8];
+	// whether uiDrawIntersectsDamage() disagreed with DamageRects anywhere in the area
+	int disagreements;
+};
+
+struct probe {
+	uiAreaRect r;
+	// translate by this much before asking
+	double dx, dy;
+};
+
+static const uiAreaRect queued[] = {
+	{ 10, 10, 20, 20 },
+	{ 100, 100, 30, 30 },
+};
+
+#define nQueued ((int) (sizeof (queued) / sizeof (queued[0])))
+
+static const struct probe probes[] = {
+	// inside the first rectangle
+	{ { 15, 15, 5, 5 }, 0, 0 },
+	// inside the second rectangle
+	{ { 110, 110, 5, 5 }, 0, 0 },
+	// between the two, so inside their bounding box but not inside either
+	{ { 60, 60, 5, 5 }, 0, 0 },
+	// past both
+	{ { 200, 150, 5, 5 }, 0, 0 },
+	// the first rectangle, asked about under a transform
+	{ { -40, -40, 5, 5 }, 50, 50 },
+	// the gap between them, under the same transform
+	{ { 10, 10, 5, 5 }, 50, 50 },
+};
+
+#define nProbes ((int) (sizeof (probes) / sizeof (probes[0])))
+
+static int overlaps(const uiAreaRect *a, const uiAreaRect *b)
+{
+	return a->X < b->X + b->Width && b->X < a->X + a->Width &&
+		a->Y < b->Y + b->Height && b->Y < a->Y + a->Height;
+}
+
+#define cell 10
+
+static void checkDamage(struct damage *s, uiAreaDrawParams *p)
+{
+	uiDrawMatrix m;
+	uiAreaRect r;
+	int i, inRects;
+
+	s->nRects = p->NumDamageRects;
+	s->bounds.X = p->ClipX;
+	s->bounds.Y = p->ClipY;
+	s->bounds.Width = p->ClipWidth;
+	s->bounds.Height = p->ClipHeight;
+
+	// every cell of the area is damaged if and only if it overlaps one of the rectangles
+	s->disagreements = 0;
+	r.Width = cell;
+	r.Height = cell;
+	for (r.Y = 0; r.Y < p->AreaHeight; r.Y += cell)
+		for (r.X = 0; r.X < p->AreaWidth; r.X += cell) {
+			inRects = 0;
+			for (i = 0; i < p->NumDamageRects; i++)
+				if (overlaps(&r, &(p->DamageRects[i])))
+					inRects = 1;
+			if (uiDrawIntersectsDamage(p->Context, r.X, r.Y, r.Width, r.Height) != inRects)
+				s->disagreements++;
+		}
+
+	for (i = 0; i < nProbes; i++) {
+		uiDrawSave(p->Context);
+		uiDrawMatrixSetIdentity(&m);
+		uiDrawMatrixTranslate(&m, probes[i].dx, probes[i].dy);
+		uiDrawTransform(p->Context, &m);
+		s->hits[i] = uiDrawIntersectsDamage(p->Context, probes[i].r.X, probes[i].r.Y, probes[i].r.Width, probes[i].r.Height);
+		uiDrawRestore(p->Context);
+	}
+}
+
+static void draw(uiAreaHandler *ah, uiArea *a, uiAreaDrawParams *p)
+{
+	struct damage *s = (struct damage *) ah;
+
+	s->draws++;
+	if (s->checking) {
+		checkDamage(s, p);
+		s->checking = 0;
+		s->checked = 1;
+	}
+}
+
+static void mouseEvent(uiAreaHandler *ah, uiArea *a, uiAreaMouseEvent *e)
+{
+}
+
+static void mouseCrossed(uiAreaHandler *ah, uiArea *a, int left)
+{
+}
+
+static void dragBroken(uiAreaHandler *ah, uiArea *a)
+{
+}
+
+static int keyEvent(uiAreaHandler *ah, uiArea *a, uiAreaKeyEvent *e)
+{
+	return 0;
+}
+
+static int setDone(void *data)
+{
+	*((int *) data) = 1;
+	return 0;
+}
+
+static uiWindow *showArea(struct damage *s, uiArea **a)
+{
+	uiWindow *w;
+	int settled = 0;
+
+	s->ah.Draw = draw;
+	s->ah.MouseEvent = mouseEvent;
+	s->ah.MouseCrossed = mouseCrossed;
+	s->ah.DragBroken = dragBroken;
+	s->ah.KeyEvent = keyEvent;
+	w = uiNewWindow("Unit Test", UNIT_TEST_WINDOW_WIDTH, UNIT_TEST_WINDOW_HEIGHT, 0);
+	*a = uiNewArea(&(s->ah));
+	uiWindowSetChild(w, uiControl(*a));
+	uiControlShow(uiControl(w));
+	while (s->draws == 0)
+		uiMainStep(1);
+	// let the window finish whatever redraws showing it set off, so the only damage left is the test's own
+	uiTimerStart(100, uiTimerModeFixedDelay, setDone, &settled);
+	unitMainUntil(&settled);
+	return w;
+}
+
+static void damageQueueRedrawRects(void **state)
+{
+	struct damage s = {0};
+	uiWindow *w;
+	uiArea *a;
+
+	w = showArea(&s, &a);
+	s.checking = 1;
+	uiAreaQueueRedrawRects(a, queued, nQueued);
+	unitMainUntil(&(s.checked));
+
+	// the two rectangles are far apart, so they're redrawn separately rather than as their bounding box
+	assert_true(s.nRects >= nQueued);
+	assert_true(s.bounds.X <= queued[0].X);
+	assert_true(s.bounds.Y <= queued[0].Y);
+	assert_true(s.bounds.X + s.bounds.Width >= queued[1].X + queued[1].Width);
+	assert_true(s.bounds.Y + s.bounds.Height >= queued[1].Y + queued[1].Height);
+	assert_int_equal(s.disagreements, 0);
+	assert_true(s.hits[0]);
+	assert_true(s.hits[1]);
+	assert_false(s.hits[2]);
+	assert_false(s.hits[3]);
+	assert_true(s.hits[4]);
+	assert_false(s.hits[5]);
+
+	uiControlDestroy(uiControl(w));
+}
+
+static void damageQueueRedrawRect(void **state)
+{
+	struct damage s = {0};
+	uiWindow *w;
+	uiArea *a;
+
+	w = showArea(&s, &a);
+	s.checking = 1;
+	uiAreaQueueRedrawRect(a, queued[0].X, queued[0].Y, queued[0].Width, queued[0].Height);
+	unitMainUntil(&(s.checked));
+
+	assert_int_equal(s.disagreements, 0);
+	assert_true(s.hits[0]);
+	assert_false(s.hits[1]);
+	assert_false(s.hits[2]);
+	assert_false(s.hits[3]);
+	assert_true(s.hits[4]);
+	assert_false(s.hits[5]);
+
+	uiControlDestroy(uiControl(w));
+}
+
+int damageRunUnitTests(void)
+{
+	const struct CMUnitTest tests[] = {
+		cmocka_unit_test_setup_teardown(damageQueueRedrawRects, unitInitSetup, unitUninitTeardown),
+		cmocka_unit_test_setup_teardown(damageQueueRedrawRect, unitInitSetup, unitUninitTeardown),
+	};
+
+	return cmocka_run_group_tests_name("uiAreaQueueRedrawRects", tests, NULL, NULL);
+}
@@ -0,0 +1,286 @@
+#include <gtk/gtk.h>
+#include "unit.h"
+#include "../../ui_unix.h"
+
+// these check that gradients come out the same whether they're built fresh, reused from the cache uiDrawFill() keeps, or drawn with a uiDrawCachedBrush, and that a changed brush is never mistaken for one in the cache
+// they run without a display, for the same reason drawimage.c's tests do
+
+#define SIZE 32
+
+static uiDrawBrushGradientStop twoStops[] = {
+	{ 0.0, 1.0, 0.0, 0.0, 1.0 },
+	{ 1.0, 0.0, 0.0, 1.0, 1.0 },
+};
+
+static void linearBrush(uiDrawBrush *b, uiDrawBrushGradientStop *stops, size_t n)
+{
+	memset(b, 0, sizeof (uiDrawBrush));
+	b->Type = uiDrawBrushTypeLinearGradient;
+	b->X0 = 0;
+	b->Y0 = 0;
+	b->X1 = SIZE;
+	b->Y1 = SIZE / 2;
+	b->Stops = stops;
+	b->NumStops = n;
+}
+
+static void radialBrush(uiDrawBrush *b, uiDrawBrushGradientStop *stops, size_t n)
+{
+	memset(b, 0, sizeof (uiDrawBrush));
+	b->Type = uiDrawBrushTypeRadialGradient;
+	b->X0 = SIZE / 4;
+	b->Y0 = SIZE / 4;
+	b->X1 = SIZE / 2;
+	b->Y1 = SIZE / 2;
+	b->OuterRadius = SIZE / 2;
+	b->Stops = stops;
+	b->NumStops = n;
+}
+
+static uiDrawPath *wholeImage(void)
+{
+	uiDrawPath *p;
+
+	p = uiDrawNewPath(uiDrawFillModeWinding);
+	uiDrawPathAddRectangle(p, 0, 0, SIZE, SIZE);
+	uiDrawPathEnd(p);
+	return p;
+}
+
+static uiUnixDrawImage *fill(uiDrawBrush *b)
+{
+	uiUnixDrawImage *img;
+	uiDrawPath *p;
+
+	img = uiUnixNewDrawImage(SIZE, SIZE);
+	p = wholeImage();
+	uiDrawFill(uiUnixDrawImageContext(img), p, b);
+	uiDrawFreePath(p);
+	return img;
+}
+
+static uiUnixDrawImage *fillCached(uiDrawCachedBrush *cb)
+{
+	uiUnixDrawImage *img;
+	uiDrawPath *p;
+
+	img = uiUnixNewDrawImage(SIZE, SIZE);
+	p = wholeImage();
+	uiDrawCachedBrushFill(uiUnixDrawImageContext(img), p, cb);
+	uiDrawFreePath(p);
+	return img;
+}
+
+// the same gradient built with cairo directly, so nothing libui caches is involved
+static cairo_surface_t *reference(const uiDrawBrush *b)
+{
+	cairo_surface_t *s;
+	cairo_t *cr;
+	cairo_pattern_t *pat;
+	size_t i;
+
+	if (b->Type == uiDrawBrushTypeLinearGradient)
+		pat = cairo_pattern_create_linear(b->X0, b->Y0, b->X1, b->Y1);
+	else
+		pat = cairo_pattern_create_radial(b->X0, b->Y0, 0, b->X1, b->Y1, b->OuterRadius);
+	for (i = 0; i < b->NumStops; i++)
+		cairo_pattern_add_color_stop_rgba(pat, b->Stops[i].Pos,
+			b->Stops[i].R, b->Stops[i].G, b->Stops[i].B, b->Stops[i].A);
+	s = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, SIZE, SIZE);
+	cr = cairo_create(s);
+	cairo_set_source(cr, pat);
+	cairo_rectangle(cr, 0, 0, SIZE, SIZE);
+	cairo_fill(cr);
+	cairo_destroy(cr);
+	cairo_pattern_destroy(pat);
+	cairo_surface_flush(s);
+	return s;
+}
+
+static int samePixels(uiUnixDrawImage *img, const uint8_t *want, int wantStride)
+{
+	const uint8_t *got;
+	int stride, y;
+
+	got = uiUnixDrawImageData(img, &stride);
+	for (y = 0; y < SIZE; y++)
+		if (memcmp(got + y * stride, want + y * wantStride, SIZE * 4) != 0)
+			return 0;
+	return 1;
+}
+
+static int sameAsImage(uiUnixDrawImage *img, uiUnixDrawImage *want)
+{
+	const uint8_t *data;
+	int stride;
+
+	data = uiUnixDrawImageData(want, &stride);
+	return samePixels(img, data, stride);
+}
+
+static int sameAsReference(uiUnixDrawImage *img, const uiDrawBrush *b)
+{
+	cairo_surface_t *s;
+	int same;
+
+	s = reference(b);
+	same = samePixels(img, cairo_image_surface_get_data(s), cairo_image_surface_get_stride(s));
+	cairo_surface_destroy(s);
+	return same;
+}
+
+static void drawBrushGradientRepeat(void **state)
+{
+	uiDrawBrush b;
+	uiUnixDrawImage *first, *second;
+
+	linearBrush(&b, twoStops, 2);
+	first = fill(&b);
+	// the second fill reuses the pattern the first one built
+	second = fill(&b);
+	assert_true(sameAsReference(first, &b));
+	assert_true(sameAsImage(second, first));
+	uiUnixFreeDrawImage(first);
+	uiUnixFreeDrawImage(second);
+}
+
+static void drawBrushGradientEqualStops(void **state)
+{
+	uiDrawBrushGradientStop copy[2];
+	uiDrawBrush b;
+	uiUnixDrawImage *img;
+
+	// brushes are matched by what's in them, not by where their stops are
+	memcpy(copy, twoStops, sizeof (copy));
+	linearBrush(&b, twoStops, 2);
+	uiUnixFreeDrawImage(fill(&b));
+	linearBrush(&b, copy, 2);
+	img = fill(&b);
+	assert_true(sameAsReference(img, &b));
+	uiUnixFreeDrawImage(img);
+}
+
+static void drawBrushGradientStopChanged(void **state)
+{
+	uiDrawBrushGradientStop stops[2];
+	uiDrawBrush b;
+	uiUnixDrawImage *before, *after;
+
+	memcpy(stops, twoStops, sizeof (stops));
+	linearBrush(&b, stops, 2);
+	before = fill(&b);
+	// the same brush, with the same stops array, but one color changed in place
+	stops[1].G = 1.0;
+	stops[1].B = 0.0;
+	after = fill(&b);
+	assert_false(sameAsImage(after, before));
+	assert_true(sameAsReference(after, &b));
+
+	// and a stop moved
+	uiUnixFreeDrawImage(before);
+	before = after;
+	stops[1].Pos = 0.5;
+	after = fill(&b);
+	assert_false(sameAsImage(after, before));
+	assert_true(sameAsReference(after, &b));
+
+	uiUnixFreeDrawImage(before);
+	uiUnixFreeDrawImage(after);
+}
+
+static void drawBrushGradientGeometryChanged(void **state)
+{
+	uiDrawBrush b;
+	uiUnixDrawImage *before, *after;
+
+	radialBrush(&b, twoStops, 2);
+	before = fill(&b);
+	b.OuterRadius = SIZE / 4;
+	after = fill(&b);
+	assert_false(sameAsImage(after, before));
+	assert_true(sameAsReference(after, &b));
+	uiUnixFreeDrawImage(after);
+
+	// the same points and stops as a linear gradient are a different gradient
+	b.OuterRadius = SIZE / 2;
+	b.Type = uiDrawBrushTypeLinearGradient;
+	after = fill(&b);
+	assert_false(sameAsImage(after, before));
+	assert_true(sameAsReference(after, &b));
+	uiUnixFreeDrawImage(before);
+	uiUnixFreeDrawImage(after);
+}
+
+// more than the cache holds
+#define nGradients 20
+
+static void drawBrushGradientEviction(void **state)
+{
+	uiDrawBrush b;
+	uiUnixDrawImage *img;
+	int i;
+
+	linearBrush(&b, twoStops, 2);
+	for (i = 0; i < nGradients; i++) {
+		b.X1 = i + 1;
+		uiUnixFreeDrawImage(fill(&b));
+	}
+	// each of them comes back right, whether it's still in the cache or not
+	for (i = 0; i < nGradients; i++) {
+		b.X1 = i + 1;
+		img = fill(&b);
+		assert_true(sameAsReference(img, &b));
+		uiUnixFreeDrawImage(img);
+	}
+}
+
+static void drawBrushCached(void **state)
+{
+	uiDrawBrushGradientStop stops[2];
+	uiDrawBrush b;
+	uiDrawCachedBrush *cb;
+	uiUnixDrawImage *cached, *plain;
+
+	memcpy(stops, twoStops, sizeof (stops));
+	linearBrush(&b, stops, 2);
+	cb = uiDrawNewCachedBrush(&b);
+	cached = fillCached(cb);
+	plain = fill(&b);
+	assert_true(sameAsImage(cached, plain));
+	uiUnixFreeDrawImage(cached);
+
+	// the cached brush has its own copy of the stops
+	stops[0].A = 0.5;
+	cached = fillCached(cb);
+	assert_true(sameAsImage(cached, plain));
+	uiUnixFreeDrawImage(cached);
+	uiUnixFreeDrawImage(plain);
+	uiDrawFreeCachedBrush(cb);
+
+	// solid brushes can be cached too
+	memset(&b, 0, sizeof (uiDrawBrush));
+	b.Type = uiDrawBrushTypeSolid;
+	b.G = 1.0;
+	b.A = 0.5;
+	cb = uiDrawNewCachedBrush(&b);
+	cached = fillCached(cb);
+	plain = fill(&b);
+	assert_true(sameAsImage(cached, plain));
+	uiUnixFreeDrawImage(cached);
+	uiUnixFreeDrawImage(plain);
+	uiDrawFreeCachedBrush(cb);
+}
+
+int drawBrushRunUnitTests(void)
+{
+	const struct CMUnitTest tests[] = {
+		cmocka_unit_test(drawBrushGradientRepeat),
+		cmocka_unit_test(drawBrushGradientEqualStops),
+		cmocka_unit_test(drawBrushGradientStopChanged),
+		cmocka_unit_test(drawBrushGradientGeometryChanged),
+		cmocka_unit_test(drawBrushGradientEviction),
+		cmocka_unit_test(drawBrushCached),
+	};
+
+	return cmocka_run_group_tests_name("uiDrawCachedBrush", tests, NULL, NULL);
+}
@@ -0,0 +1,220 @@
+#include <gtk/gtk.h>
+#include "unit.h"
+#include "../../ui_unix.h"
+
+// these all run without uiInit(), since uiUnixDrawImage must work without a display
+// they're built into their own executable (see headless.c), since once another test has called uiInit() the display stays open for the rest of the process, and text would be drawn through GDK instead of the fallback in drawtext.c
+
+#define WIDTH 20
+#define HEIGHT 10
+
+static uint32_t pixelAt(uiUnixDrawImage *img, int x, int y)
+{
+	uint8_t *data;
+	int stride;
+
+	data = uiUnixDrawImageData(img, &stride);
+	return *((uint32_t *) (data + y * stride + x * 4));
+}
+
+static void fillRectColor(uiDrawContext *c, double x, double y, double width, double height, double r, double g, double b)
+{
+	uiDrawPath *path;
+	uiDrawBrush brush = {0};
+
+	brush.Type = uiDrawBrushTypeSolid;
+	brush.R = r;
+	brush.G = g;
+	brush.B = b;
+	brush.A = 1.0;
+	path = uiDrawNewPath(uiDrawFillModeWinding);
+	uiDrawPathAddRectangle(path, x, y, width, height);
+	uiDrawPathEnd(path);
+	uiDrawFill(c, path, &brush);
+	uiDrawFreePath(path);
+}
+
+static void fillRect(uiDrawContext *c, double x, double y, double width, double height)
+{
+	fillRectColor(c, x, y, width, height, 1.0, 0.0, 0.0);
+}
+
+static int drawImageSetup(void **state)
+{
+	// fail the whole group rather than pass without testing anything
+	if (gdk_display_get_default() != NULL)
+		return -1;
+	return 0;
+}
+
+static void drawImageStartsTransparent(void **state)
+{
+	uiUnixDrawImage *img;
+
+	img = uiUnixNewDrawImage(WIDTH, HEIGHT);
+	assert_int_equal(pixelAt(img, 0, 0), 0);
+	assert_int_equal(pixelAt(img, WIDTH - 1, HEIGHT - 1), 0);
+	uiUnixFreeDrawImage(img);
+}
+
+static void drawImageFill(void **state)
+{
+	uiUnixDrawImage *img;
+
+	img = uiUnixNewDrawImage(WIDTH, HEIGHT);
+	fillRect(uiUnixDrawImageContext(img), 0, 0, WIDTH / 2, HEIGHT);
+	assert_int_equal(pixelAt(img, 0, 0), 0xFFFF0000);
+	assert_int_equal(pixelAt(img, WIDTH / 2 - 1, HEIGHT - 1), 0xFFFF0000);
+	assert_int_equal(pixelAt(img, WIDTH / 2, 0), 0);
+	uiUnixFreeDrawImage(img);
+}
+
+static void drawImageForData(void **state)
+{
+	uint32_t data[WIDTH * HEIGHT] = {0};
+	uiUnixDrawImage *img;
+	int stride;
+
+	img = uiUnixNewDrawImageForData((uint8_t *) data, WIDTH, HEIGHT, WIDTH * 4);
+	fillRect(uiUnixDrawImageContext(img), 1, 1, 1, 1);
+	// the pointer returned must be the caller's buffer, with the drawing flushed to it
+	assert_ptr_equal(uiUnixDrawImageData(img, &stride), data);
+	assert_int_equal(stride, WIDTH * 4);
+	assert_int_equal(data[WIDTH + 1], 0xFFFF0000);
+	assert_int_equal(data[0], 0);
+	uiUnixFreeDrawImage(img);
+}
+
+static void drawImageDisplayList(void **state)
+{
+	uiUnixDrawImage *img;
+	uiDrawContext *c;
+	uiUnixDrawDisplayList *dl;
+	uiDrawMatrix m;
+
+	img = uiUnixNewDrawImage(WIDTH, HEIGHT);
+	c = uiUnixDrawImageContext(img);
+	uiUnixDrawBeginDisplayList(c);
+	fillRect(c, 0, 0, 2, 2);
+	dl = uiUnixDrawEndDisplayList(c);
+	// recording must not draw anything by itself
+	assert_int_equal(pixelAt(img, 0, 0), 0);
+
+	// the point is to record once and replay many times
+	uiUnixDrawDisplayListDraw(c, dl, NULL);
+	uiDrawMatrixSetIdentity(&m);
+	uiDrawMatrixTranslate(&m, 10, 5);
+	uiUnixDrawDisplayListDraw(c, dl, &m);
+	uiUnixFreeDrawDisplayList(dl);
+	assert_int_equal(pixelAt(img, 1, 1), 0xFFFF0000);
+	assert_int_equal(pixelAt(img, 11, 6), 0xFFFF0000);
+	assert_int_equal(pixelAt(img, 5, 5), 0);
+	uiUnixFreeDrawImage(img);
+}
+
+#define RED 0xFFFF0000
+#define BLUE 0xFF0000FF
+
+static void drawLayer(uiDrawContext *c, uiDrawLayer *l, double r, double g, double b)
+{
+	uiDrawLayerBegin(c, l);
+	fillRectColor(c, 0, 0, WIDTH / 2, HEIGHT / 2, r, g, b);
+	uiDrawLayerEnd(c, l);
+}
+
+static void drawImageLayerScale(void **state)
+{
+	uiUnixDrawImage *img;
+	uiDrawContext *c;
+	uiDrawLayer *l;
+
+	img = uiUnixNewDrawImage(WIDTH, HEIGHT);
+	c = uiUnixDrawImageContext(img);
+	l = uiDrawNewLayer(WIDTH / 2, HEIGHT / 2);
+	assert_false(uiDrawLayerValid(c, l));
+	drawLayer(c, l, 1.0, 0.0, 0.0);
+	// drawing the contents must not draw anything by itself
+	assert_int_equal(pixelAt(img, 0, 0), 0);
+	assert_true(uiDrawLayerValid(c, l));
+	uiDrawLayerDraw(c, l, NULL, 1.0);
+	assert_int_equal(pixelAt(img, 1, 1), RED);
+	assert_int_equal(pixelAt(img, WIDTH / 2, 1), 0);
+
+	if (!uiUnixDrawImageSetScale(img, 2))
+		skip();
+	// contents drawn at scale 1 would be blurry at scale 2
+	assert_false(uiDrawLayerValid(c, l));
+	// but they're still better than nothing; they're resampled to cover the whole image now
+	uiDrawLayerDraw(c, l, NULL, 1.0);
+	assert_int_equal(pixelAt(img, WIDTH / 2, HEIGHT / 2), RED);
+	drawLayer(c, l, 0.0, 0.0, 1.0);
+	assert_true(uiDrawLayerValid(c, l));
+	uiDrawLayerDraw(c, l, NULL, 1.0);
+	// one pixel per device pixel, right up to the edge
+	assert_int_equal(pixelAt(img, 0, 0), BLUE);
+	assert_int_equal(pixelAt(img, WIDTH - 1, HEIGHT - 1), BLUE);
+
+	// going back to scale 1 finds the contents drawn there
+	assert_int_equal(uiUnixDrawImageSetScale(img, 1), 1);
+	assert_true(uiDrawLayerValid(c, l));
+	uiDrawLayerDraw(c, l, NULL, 1.0);
+	assert_int_equal(pixelAt(img, 1, 1), RED);
+	assert_int_equal(pixelAt(img, WIDTH / 2, 1), BLUE);
+
+	uiDrawLayerInvalidate(l);
+	assert_false(uiDrawLayerValid(c, l));
+	assert_int_equal(uiUnixDrawImageSetScale(img, 2), 1);
+	assert_false(uiDrawLayerValid(c, l));
+
+	uiDrawFreeLayer(l);
+	uiUnixFreeDrawImage(img);
+}
+
+static void drawImageText(void **state)
+{
+	uiUnixDrawImage *img;
+	uiAttributedString *s;
+	uiFontDescriptor font = {0};
+	uiDrawTextLayoutParams p = {0};
+	uiDrawTextLayout *tl;
+	int x, y, inked;
+
+	img = uiUnixNewDrawImage(WIDTH, HEIGHT);
+	s = uiNewAttributedString("WW");
+	font.Family = "sans";
+	font.Size = 12;
+	font.Weight = uiTextWeightNormal;
+	font.Italic = uiTextItalicNormal;
+	font.Stretch = uiTextStretchNormal;
+	p.String = s;
+	p.DefaultFont = &font;
+	p.Width = -1;
+	p.Align = uiDrawTextAlignLeft;
+	tl = uiDrawNewTextLayout(&p);
+	uiDrawText(uiUnixDrawImageContext(img), tl, 0, 0);
+	uiDrawFreeTextLayout(tl);
+	uiFreeAttributedString(s);
+
+	// even with no fonts installed, Pango draws boxes for missing glyphs
+	inked = 0;
+	for (y = 0; y < HEIGHT; y++)
+		for (x = 0; x < WIDTH; x++)
+			if (pixelAt(img, x, y) != 0)
+				inked = 1;
+	assert_true(inked);
+	uiUnixFreeDrawImage(img);
+}
+
+int drawImageRunUnitTests(void)
+{
+	const struct CMUnitTest tests[] = {
+		cmocka_unit_test(drawImageStartsTransparent),
+		cmocka_unit_test(drawImageFill),
+		cmocka_unit_test(drawImageForData),
+		cmocka_unit_test(drawImageDisplayList),
+		cmocka_unit_test(drawImageLayerScale),
+		cmocka_unit_test(drawImageText),
+	};
+
+	return cmocka_run_group_tests_name("uiUnixDrawImage", tests, drawImageSetup, NULL);
+}
@@ -0,0 +1,477 @@
+#include <gtk/gtk.h>
+#include "unit.h"
+#include "../../ui_unix.h"
+
+// these check that uiDrawPath draws exactly what the same figure drawn with cairo calls of its own does, and that the different ways of building a figure agree, pixel for pixel
+// they run without a display, for the same reason drawimage.c's tests do
+
+#define SIZE 64
+
+static void fillBrush(uiDrawBrush *b)
+{
+	memset(b, 0, sizeof (uiDrawBrush));
+	b->Type = uiDrawBrushTypeSolid;
+	b->R = 1.0;
+	b->A = 1.0;
+}
+
+static void strokeBrush(uiDrawBrush *b)
+{
+	memset(b, 0, sizeof (uiDrawBrush));
+	b->Type = uiDrawBrushTypeSolid;
+	b->B = 1.0;
+	b->A = 0.5;
+}
+
+// the path is filled and then stroked, so that open figures and the joins between pieces both show up in the pixels
+static uiUnixDrawImage *drawPath(uiDrawPath *p)
+{
+	uiUnixDrawImage *img;
+	uiDrawContext *c;
+	uiDrawBrush b;
+	uiDrawStrokeParams sp = {0};
+
+	uiDrawPathEnd(p);
+	img = uiUnixNewDrawImage(SIZE, SIZE);
+	c = uiUnixDrawImageContext(img);
+	fillBrush(&b);
+	uiDrawFill(c, p, &b);
+	strokeBrush(&b);
+	sp.Cap = uiDrawLineCapFlat;
+	sp.Join = uiDrawLineJoinMiter;
+	sp.Thickness = 2;
+	sp.MiterLimit = uiDrawDefaultMiterLimit;
+	uiDrawStroke(c, p, &b, &sp);
+	return img;
+}
+
+static void assertSamePixels(const uint8_t *got, int gotStride, const uint8_t *want, int wantStride)
+{
+	uint32_t g, w;
+	int x, y;
+
+	for (y = 0; y < SIZE; y++)
+		for (x = 0; x < SIZE; x++) {
+			g = *((const uint32_t *) (got + y * gotStride + x * 4));
+			w = *((const uint32_t *) (want + y * wantStride + x * 4));
+			if (g != w)
+				fail_msg("pixel (%d, %d) is %08x, want %08x", x, y, g, w);
+		}
+}
+
+// draws the figure that reference() makes with cairo the way drawPath() would, and compares the two
+static void assertSameAsCairo(uiDrawPath *p, void (*reference)(cairo_t *))
+{
+	uiUnixDrawImage *img;
+	cairo_surface_t *s;
+	cairo_t *cr;
+	uint8_t *data;
+	int stride;
+
+	img = drawPath(p);
+	s = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, SIZE, SIZE);
+	cr = cairo_create(s);
+	(*reference)(cr);
+	cairo_set_fill_rule(cr, CAIRO_FILL_RULE_WINDING);
+	cairo_set_source_rgba(cr, 1, 0, 0, 1);
+	cairo_fill_preserve(cr);
+	cairo_set_line_cap(cr, CAIRO_LINE_CAP_BUTT);
+	cairo_set_line_join(cr, CAIRO_LINE_JOIN_MITER);
+	cairo_set_miter_limit(cr, uiDrawDefaultMiterLimit);
+	cairo_set_line_width(cr, 2);
+	cairo_set_source_rgba(cr, 0, 0, 1, 0.5);
+	cairo_stroke(cr);
+	cairo_surface_flush(s);
+	data = uiUnixDrawImageData(img, &stride);
+	assertSamePixels(data, stride,
+		cairo_image_surface_get_data(s), cairo_image_surface_get_stride(s));
+	cairo_destroy(cr);
+	cairo_surface_destroy(s);
+	uiUnixFreeDrawImage(img);
+}
+
+// draws both paths and compares the results; this frees both paths
+static void assertSameAsPath(uiDrawPath *got, uiDrawPath *want)
+{
+	uiUnixDrawImage *gotImg, *wantImg;
+	uint8_t *gotData, *wantData;
+	int gotStride, wantStride;
+
+	gotImg = drawPath(got);
+	wantImg = drawPath(want);
+	gotData = uiUnixDrawImageData(gotImg, &gotStride);
+	wantData = uiUnixDrawImageData(wantImg, &wantStride);
+	assertSamePixels(gotData, gotStride, wantData, wantStride);
+	uiUnixFreeDrawImage(wantImg);
+	uiUnixFreeDrawImage(gotImg);
+	uiDrawFreePath(want);
+	uiDrawFreePath(got);
+}
+
+static int drawPathSetup(void **state)
+{
+	// fail the whole group rather than pass without testing anything
+	if (gdk_display_get_default() != NULL)
+		return -1;
+	return 0;
+}
+
+static void linesCairo(cairo_t *cr)
+{
+	cairo_move_to(cr, 10, 10);
+	cairo_line_to(cr, 50, 12.5);
+	cairo_line_to(cr, 40.25, 50);
+	cairo_close_path(cr);
+	// an open figure
+	cairo_move_to(cr, 5, 60);
+	cairo_line_to(cr, 60, 55);
+}
+
+static void drawPathLines(void **state)
+{
+	uiDrawPath *p;
+
+	p = uiDrawNewPath(uiDrawFillModeWinding);
+	uiDrawPathNewFigure(p, 10, 10);
+	uiDrawPathLineTo(p, 50, 12.5);
+	uiDrawPathLineTo(p, 40.25, 50);
+	uiDrawPathCloseFigure(p);
+	uiDrawPathNewFigure(p, 5, 60);
+	uiDrawPathLineTo(p, 60, 55);
+	assertSameAsCairo(p, linesCairo);
+	uiDrawFreePath(p);
+}
+
+static void bezierCairo(cairo_t *cr)
+{
+	cairo_move_to(cr, 5, 5);
+	cairo_curve_to(cr, 60, 0, 0, 60, 58, 58);
+	cairo_close_path(cr);
+}
+
+static void drawPathBezier(void **state)
+{
+	uiDrawPath *p;
+
+	p = uiDrawNewPath(uiDrawFillModeWinding);
+	uiDrawPathNewFigure(p, 5, 5);
+	uiDrawPathBezierTo(p, 60, 0, 0, 60, 58, 58);
+	uiDrawPathCloseFigure(p);
+	assertSameAsCairo(p, bezierCairo);
+	uiDrawFreePath(p);
+}
+
+static void rectangleCairo(cairo_t *cr)
+{
+	cairo_rectangle(cr, 8, 8, 40, 24);
+}
+
+static void drawPathRectangle(void **state)
+{
+	uiDrawPath *p;
+
+	p = uiDrawNewPath(uiDrawFillModeWinding);
+	uiDrawPathAddRectangle(p, 8, 8, 40, 24);
+	assertSameAsCairo(p, rectangleCairo);
+	uiDrawFreePath(p);
+}
+
+// arcs are kept out of line of the other pieces (see unix/drawpath.c), so mix them up: an arc right after a line, an arc right after another arc, lines after an arc, and a path that ends on an arc
+static void arcsAndLinesCairo(cairo_t *cr)
+{
+	cairo_move_to(cr, 10, 10);
+	cairo_line_to(cr, 30, 10);
+	cairo_arc(cr, 30, 30, 20, -G_PI / 2, 0);
+	cairo_arc_negative(cr, 40, 40, 10, 0, -G_PI / 2);
+	cairo_line_to(cr, 20, 50);
+	cairo_line_to(cr, 10, 40);
+	cairo_close_path(cr);
+	cairo_move_to(cr, 60, 60);
+	cairo_arc(cr, 50, 60, 10, 0, G_PI / 2);
+}
+
+static void drawPathArcsAndLines(void **state)
+{
+	uiDrawPath *p;
+
+	p = uiDrawNewPath(uiDrawFillModeWinding);
+	uiDrawPathNewFigure(p, 10, 10);
+	uiDrawPathLineTo(p, 30, 10);
+	uiDrawPathArcTo(p, 30, 30, 20, -uiPi / 2, uiPi / 2, 0);
+	uiDrawPathArcTo(p, 40, 40, 10, 0, -uiPi / 2, 1);
+	uiDrawPathLineTo(p, 20, 50);
+	uiDrawPathLineTo(p, 10, 40);
+	uiDrawPathCloseFigure(p);
+	uiDrawPathNewFigure(p, 60, 60);
+	uiDrawPathArcTo(p, 50, 60, 10, 0, uiPi / 2, 0);
+	assertSameAsCairo(p, arcsAndLinesCairo);
+	uiDrawFreePath(p);
+}
+
+// the first figure starts with an arc, at the very start of the path; the second starts with one after a figure of lines, which must not be joined to it
+static void newFigureWithArcCairo(cairo_t *cr)
+{
+	cairo_new_sub_path(cr);
+	cairo_arc(cr, 20, 20, 12, 0, 3 * G_PI / 2);
+	cairo_line_to(cr, 20, 20);
+	cairo_close_path(cr);
+	cairo_move_to(cr, 5, 60);
+	cairo_line_to(cr, 30, 40);
+	cairo_new_sub_path(cr);
+	cairo_arc_negative(cr, 45, 45, 12, G_PI, 0);
+	cairo_close_path(cr);
+}
+
+static void drawPathNewFigureWithArc(void **state)
+{
+	uiDrawPath *p;
+
+	p = uiDrawNewPath(uiDrawFillModeWinding);
+	uiDrawPathNewFigureWithArc(p, 20, 20, 12, 0, 3 * uiPi / 2, 0);
+	uiDrawPathLineTo(p, 20, 20);
+	uiDrawPathCloseFigure(p);
+	uiDrawPathNewFigure(p, 5, 60);
+	uiDrawPathLineTo(p, 30, 40);
+	uiDrawPathNewFigureWithArc(p, 45, 45, 12, uiPi, -uiPi, 1);
+	uiDrawPathCloseFigure(p);
+	assertSameAsCairo(p, newFigureWithArcCairo);
+	uiDrawFreePath(p);
+}
+
+static void addFigure(uiDrawPath *p)
+{
+	uiDrawPathNewFigure(p, 4, 4);
+	uiDrawPathLineTo(p, 30, 6);
+	uiDrawPathArcTo(p, 30, 30, 24, -uiPi / 2, uiPi, 0);
+	uiDrawPathBezierTo(p, 20, 60, 4, 40, 8, 30);
+	uiDrawPathCloseFigure(p);
+}
+
+static void addOtherFigure(uiDrawPath *p)
+{
+	uiDrawPathNewFigureWithArc(p, 40, 40, 16, 0, 2 * uiPi, 0);
+	uiDrawPathCloseFigure(p);
+	uiDrawPathAddRectangle(p, 2, 2, 20, 10);
+}
+
+static void drawPathResetReuse(void **state)
+{
+	uiDrawPath *p, *want;
+	uiUnixDrawImage *img;
+
+	p = uiDrawNewPath(uiDrawFillModeWinding);
+	addFigure(p);
+	img = drawPath(p);
+	uiUnixFreeDrawImage(img);
+	uiDrawPathReset(p);
+	assert_int_equal(uiDrawPathEnded(p), 0);
+	// the arcs land at different places this time, and there are fewer elements than before
+	addOtherFigure(p);
+	want = uiDrawNewPath(uiDrawFillModeWinding);
+	addOtherFigure(want);
+	assertSameAsPath(p, want);
+}
+
+static void drawPathResetEmpty(void **state)
+{
+	uiDrawPath *p, *want;
+
+	// an empty path draws nothing, whether or not it ever held anything
+	p = uiDrawNewPath(uiDrawFillModeWinding);
+	addFigure(p);
+	uiDrawPathEnd(p);
+	uiDrawPathReset(p);
+	want = uiDrawNewPath(uiDrawFillModeWinding);
+	assertSameAsPath(p, want);
+}
+
+static void drawPathReserve(void **state)
+{
+	uiDrawPath *p, *want;
+
+	p = uiDrawNewPath(uiDrawFillModeWinding);
+	uiDrawPathReserve(p, 1000);
+	addFigure(p);
+	want = uiDrawNewPath(uiDrawFillModeWinding);
+	addFigure(want);
+	assertSameAsPath(p, want);
+}
+
+static void drawPathReserveKeepsContents(void **state)
+{
+	uiDrawPath *p, *want;
+
+	// reserving more than the path has room for moves what's already there
+	p = uiDrawNewPath(uiDrawFillModeWinding);
+	addFigure(p);
+	uiDrawPathReserve(p, 1000);
+	uiDrawPathReserve(p, 0);
+	addOtherFigure(p);
+	want = uiDrawNewPath(uiDrawFillModeWinding);
+	addFigure(want);
+	addOtherFigure(want);
+	assertSameAsPath(p, want);
+}
+
+// the bulk calls, each against the per-call sequence it stands for, with n of 0, 1, and several
+static const double points[] = {
+	4, 4,
+	60, 8,
+	50.5, 40,
+	20, 58.25,
+	8, 30,
+};
+
+#define nPoints ((int) (sizeof (points) / (2 * sizeof (double))))
+
+// in both of these, the last shape overlaps the others to put the fill rule to work
+static const double rects[] = {
+	4, 4, 20, 12,
+	40, 30, 14, 8,
+	10, 10, 40, 40,
+};
+
+static const double circles[] = {
+	16, 16, 10,
+	44, 40, 12,
+	32, 32, 24,
+};
+
+#define nShapes 3
+
+// each bulk call is made between two other figures, so that a bulk call that adds too much, too little, or leaves a figure open shows up
+static void before(uiDrawPath *p)
+{
+	uiDrawPathAddRectangle(p, 30, 2, 8, 8);
+}
+
+static void after(uiDrawPath *p)
+{
+	uiDrawPathLineTo(p, 62, 62);
+	uiDrawPathNewFigure(p, 2, 62);
+	uiDrawPathLineTo(p, 30, 50);
+}
+
+static void polylineCalls(uiDrawPath *p, int n)
+{
+	int i;
+
+	if (n == 0)
+		return;
+	uiDrawPathNewFigure(p, points[0], points[1]);
+	for (i = 1; i < n; i++)
+		uiDrawPathLineTo(p, points[2 * i], points[2 * i + 1]);
+}
+
+static void assertPolyline(int n, int polygon)
+{
+	uiDrawPath *p, *want;
+
+	p = uiDrawNewPath(uiDrawFillModeWinding);
+	before(p);
+	if (polygon)
+		uiDrawPathAddPolygon(p, points, n);
+	else
+		uiDrawPathAddPolyline(p, points, n);
+	// for n == 0 this continues the rectangle's figure, which is fine, as long as both paths agree
+	after(p);
+	want = uiDrawNewPath(uiDrawFillModeWinding);
+	before(want);
+	polylineCalls(want, n);
+	if (polygon && n != 0)
+		uiDrawPathCloseFigure(want);
+	after(want);
+	assertSameAsPath(p, want);
+}
+
+static void drawPathAddPolyline(void **state)
+{
+	assertPolyline(0, 0);
+	assertPolyline(1, 0);
+	assertPolyline(nPoints, 0);
+}
+
+static void drawPathAddPolygon(void **state)
+{
+	assertPolyline(0, 1);
+	assertPolyline(1, 1);
+	assertPolyline(nPoints, 1);
+}
+
+static void assertRectangles(int n, uiDrawFillMode mode)
+{
+	uiDrawPath *p, *want;
+	const double *r;
+	int i;
+
+	p = uiDrawNewPath(mode);
+	before(p);
+	uiDrawPathAddRectangles(p, rects, n);
+	after(p);
+	want = uiDrawNewPath(mode);
+	before(want);
+	for (i = 0; i < n; i++) {
+		r = rects + 4 * i;
+		uiDrawPathAddRectangle(want, r[0], r[1], r[2], r[3]);
+	}
+	after(want);
+	assertSameAsPath(p, want);
+}
+
+static void drawPathAddRectangles(void **state)
+{
+	assertRectangles(0, uiDrawFillModeWinding);
+	assertRectangles(1, uiDrawFillModeWinding);
+	assertRectangles(nShapes, uiDrawFillModeWinding);
+	assertRectangles(nShapes, uiDrawFillModeAlternate);
+}
+
+static void assertCircles(int n, uiDrawFillMode mode)
+{
+	uiDrawPath *p, *want;
+	const double *c;
+	int i;
+
+	p = uiDrawNewPath(mode);
+	before(p);
+	uiDrawPathAddCircles(p, circles, n);
+	after(p);
+	want = uiDrawNewPath(mode);
+	before(want);
+	for (i = 0; i < n; i++) {
+		c = circles + 3 * i;
+		uiDrawPathNewFigureWithArc(want, c[0], c[1], c[2], 0, 2 * uiPi, 0);
+		uiDrawPathCloseFigure(want);
+	}
+	after(want);
+	assertSameAsPath(p, want);
+}
+
+static void drawPathAddCircles(void **state)
+{
+	assertCircles(0, uiDrawFillModeWinding);
+	assertCircles(1, uiDrawFillModeWinding);
+	assertCircles(nShapes, uiDrawFillModeWinding);
+	assertCircles(nShapes, uiDrawFillModeAlternate);
+}
+
+int drawPathRunUnitTests(void)
+{
+	const struct CMUnitTest tests[] = {
+		cmocka_unit_test(drawPathLines),
+		cmocka_unit_test(drawPathBezier),
+		cmocka_unit_test(drawPathRectangle),
+		cmocka_unit_test(drawPathArcsAndLines),
+		cmocka_unit_test(drawPathNewFigureWithArc),
+		cmocka_unit_test(drawPathResetReuse),
+		cmocka_unit_test(drawPathResetEmpty),
+		cmocka_unit_test(drawPathReserve),
+		cmocka_unit_test(drawPathReserveKeepsContents),
+		cmocka_unit_test(drawPathAddPolyline),
+		cmocka_unit_test(drawPathAddPolygon),
+		cmocka_unit_test(drawPathAddRectangles),
+		cmocka_unit_test(drawPathAddCircles),
+	};
+
+	return cmocka_run_group_tests_name("uiDrawPath", tests, drawPathSetup, NULL);
+}
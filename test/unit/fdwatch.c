@@ -0,0 +1,182 @@
+#include <unistd.h>
+#include <gtk/gtk.h>
+#include "unit.h"
+#include "../../ui_unix.h"
+
+// these test uiUnixWatchFD() on a pipe
+
+struct watched {
+	uiUnixFDWatch *w;
+	int fd;
+	int calls;
+	int conditions;
+	// what the callback returns
+	int keep;
+	// remove the watch from the callback instead of returning 0
+	int remove;
+	char got;
+	int done;
+};
+
+static int onFD(uiUnixFDWatch *w, int fd, int conditions, void *data)
+{
+	struct watched *s = (struct watched *) data;
+
+	assert_ptr_equal(w, s->w);
+	assert_int_equal(fd, s->fd);
+	s->calls++;
+	s->conditions = conditions;
+	if ((conditions & uiUnixFDReadable) != 0)
+		assert_int_equal(read(fd, &(s->got), 1), 1);
+	s->done = 1;
+	if (s->remove) {
+		uiUnixFDWatchRemove(w);
+		return 1;
+	}
+	return s->keep;
+}
+
+static int setDone(void *data)
+{
+	*((int *) data) = 1;
+	return 0;
+}
+
+// runs the main loop for a while, so that a watch that shouldn't fire has every chance to
+static void runFor(int milliseconds)
+{
+	int done = 0;
+
+	uiTimerStart(milliseconds, uiTimerModeFixedDelay, setDone, &done);
+	unitMainUntil(&done);
+}
+
+static void newPipe(int p[2])
+{
+	assert_int_equal(pipe(p), 0);
+}
+
+static void closePipe(int p[2])
+{
+	if (p[0] != -1)
+		close(p[0]);
+	if (p[1] != -1)
+		close(p[1]);
+}
+
+static void fdWatchReadable(void **state)
+{
+	struct watched s = {0};
+	int p[2];
+
+	newPipe(p);
+	s.fd = p[0];
+	s.keep = 1;
+	s.w = uiUnixWatchFD(p[0], uiUnixFDReadable, onFD, &s);
+	// nothing to read yet
+	runFor(20);
+	assert_int_equal(s.calls, 0);
+
+	assert_int_equal(write(p[1], "a", 1), 1);
+	unitMainUntil(&(s.done));
+	assert_int_equal(s.calls, 1);
+	assert_int_equal(s.conditions, uiUnixFDReadable);
+	assert_int_equal(s.got, 'a');
+
+	// the watch stays as long as the callback returns nonzero
+	s.done = 0;
+	s.keep = 0;
+	assert_int_equal(write(p[1], "b", 1), 1);
+	unitMainUntil(&(s.done));
+	assert_int_equal(s.calls, 2);
+	assert_int_equal(s.got, 'b');
+
+	// and is gone once it returns 0
+	assert_int_equal(write(p[1], "c", 1), 1);
+	runFor(20);
+	assert_int_equal(s.calls, 2);
+	closePipe(p);
+}
+
+static void fdWatchRemoveFromCallback(void **state)
+{
+	struct watched s = {0};
+	int p[2];
+
+	newPipe(p);
+	s.fd = p[0];
+	s.remove = 1;
+	s.w = uiUnixWatchFD(p[0], uiUnixFDReadable, onFD, &s);
+	assert_int_equal(write(p[1], "a", 1), 1);
+	unitMainUntil(&(s.done));
+	assert_int_equal(write(p[1], "b", 1), 1);
+	runFor(20);
+	assert_int_equal(s.calls, 1);
+	closePipe(p);
+}
+
+static void fdWatchRemove(void **state)
+{
+	struct watched s = {0};
+	int p[2];
+
+	newPipe(p);
+	s.fd = p[0];
+	s.keep = 1;
+	s.w = uiUnixWatchFD(p[0], uiUnixFDReadable, onFD, &s);
+	uiUnixFDWatchRemove(s.w);
+	assert_int_equal(write(p[1], "a", 1), 1);
+	runFor(20);
+	assert_int_equal(s.calls, 0);
+	closePipe(p);
+}
+
+static void fdWatchHangup(void **state)
+{
+	struct watched s = {0};
+	int p[2];
+
+	newPipe(p);
+	s.fd = p[0];
+	s.keep = 0;
+	// hangups are reported even though only uiUnixFDReadable was asked for
+	s.w = uiUnixWatchFD(p[0], uiUnixFDReadable, onFD, &s);
+	close(p[1]);
+	p[1] = -1;
+	unitMainUntil(&(s.done));
+	assert_int_equal(s.calls, 1);
+	assert_true((s.conditions & uiUnixFDError) != 0);
+	closePipe(p);
+}
+
+static void fdWatchSetConditions(void **state)
+{
+	struct watched s = {0};
+	int p[2];
+
+	newPipe(p);
+	s.fd = p[1];
+	s.keep = 0;
+	// an empty pipe is always writable, so this would fire right away if it were watching for that
+	s.w = uiUnixWatchFD(p[1], 0, onFD, &s);
+	runFor(20);
+	assert_int_equal(s.calls, 0);
+	uiUnixFDWatchSetConditions(s.w, uiUnixFDWritable);
+	unitMainUntil(&(s.done));
+	assert_int_equal(s.calls, 1);
+	assert_int_equal(s.conditions, uiUnixFDWritable);
+	closePipe(p);
+}
+
+int fdWatchRunUnitTests(void)
+{
+	const struct CMUnitTest tests[] = {
+		cmocka_unit_test_setup_teardown(fdWatchReadable, unitInitSetup, unitUninitTeardown),
+		cmocka_unit_test_setup_teardown(fdWatchRemoveFromCallback, unitInitSetup, unitUninitTeardown),
+		cmocka_unit_test_setup_teardown(fdWatchRemove, unitInitSetup, unitUninitTeardown),
+		cmocka_unit_test_setup_teardown(fdWatchHangup, unitInitSetup, unitUninitTeardown),
+		cmocka_unit_test_setup_teardown(fdWatchSetConditions, unitInitSetup, unitUninitTeardown),
+	};
+
+	return cmocka_run_group_tests_name("uiUnixWatchFD", tests, NULL, NULL);
+}
@@ -0,0 +1,22 @@
+#include <stdio.h>
+
+#include "unit.h"
+
+// the tests that must run without a display; see drawimage.c
+
+int main(void)
+{
+	int failedTests;
+
+	failedTests = drawImageRunUnitTests();
+	failedTests += drawPathRunUnitTests();
+	failedTests += drawBrushRunUnitTests();
+
+	puts("[==========]");
+	if (failedTests == 0)
+		puts("[  PASSED  ] All test(s) in all component(s).");
+	else
+		printf("[  FAILED  ] %d test(s), see above.\n", failedTests);
+
+	return failedTests;
+}
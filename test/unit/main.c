@@ -46,6 +46,27 @@ int unitTestTeardown(void **_state)
 	return 0;
 }
 
+int unitInitSetup(void **state)
+{
+	uiInitOptions o = {0};
+
+	assert_null(uiInit(&o));
+	uiMainSteps();
+	return 0;
+}
+
+int unitUninitTeardown(void **state)
+{
+	uiUninit();
+	return 0;
+}
+
+void unitMainUntil(const int *done)
+{
+	while (!*done)
+		uiMainStep(1);
+}
+
 struct unitTest {
 	int (*fn)(void);
 };
@@ -68,6 +89,16 @@ int main(void)
 		{ entryRunUnitTests },
 		{ progressBarRunUnitTests },
 		{ drawMatrixRunUnitTests },
+#if !defined(_WIN32) && !defined(__APPLE__)
+		{ workerRunUnitTests },
+		{ timerRunUnitTests },
+		{ queueRunUnitTests },
+		{ allocRunUnitTests },
+		{ schedulerRunUnitTests },
+		{ watchdogRunUnitTests },
+		{ fdWatchRunUnitTests },
+		{ damageRunUnitTests },
+#endif
 	};
 
 	for (i = 0; i < sizeof(unitTests)/sizeof(*unitTests); ++i) {
@@ -0,0 +1,147 @@
+#include <glib.h>
+#include "unit.h"
+
+// these test the Unix queue; the other platforms don't coalesce keyed calls or honor priorities yet (see ui.h)
+
+#define nCalls 16
+
+static const char *calls[nCalls];
+static int nCallsMade;
+static int done;
+
+static void resetCalls(void)
+{
+	nCallsMade = 0;
+	done = 0;
+}
+
+static void record(void *data)
+{
+	calls[nCallsMade++] = (const char *) data;
+}
+
+static void recordLast(void *data)
+{
+	record(data);
+	done = 1;
+}
+
+static void assertCalls(const char *want[], int n)
+{
+	int i;
+
+	assert_int_equal(nCallsMade, n);
+	for (i = 0; i < n; i++)
+		assert_string_equal(calls[i], want[i]);
+}
+
+static int nFreed;
+
+static void countFree(void *data)
+{
+	nFreed++;
+}
+
+static const char *values[] = { "one", "two", "three", "four", "five" };
+
+#define nValues ((int) (sizeof (values) / sizeof (values[0])))
+
+static void queueKeyedCoalesces(void **state)
+{
+	const char *want[] = { "five" };
+	int i;
+
+	resetCalls();
+	nFreed = 0;
+	for (i = 0; i < nValues; i++)
+		uiQueueMainKeyed(&done, recordLast, (void *) values[i], countFree);
+	unitMainUntil(&done);
+	assertCalls(want, 1);
+	assert_int_equal(nFreed, nValues - 1);
+}
+
+static void queueKeyedKeepsOrder(void **state)
+{
+	const char *want[] = { "a", "keyed two", "b", "c" };
+
+	resetCalls();
+	nFreed = 0;
+	// a replaced call keeps the place of the one it replaces
+	uiQueueMain(record, "a");
+	uiQueueMainKeyed(&done, record, "keyed one", countFree);
+	uiQueueMain(record, "b");
+	uiQueueMainKeyed(&done, record, "keyed two", countFree);
+	uiQueueMain(recordLast, "c");
+	unitMainUntil(&done);
+	assertCalls(want, 4);
+	assert_int_equal(nFreed, 1);
+}
+
+static int reposted;
+
+static void repost(void *data)
+{
+	record(data);
+	if (!reposted) {
+		reposted = 1;
+		uiQueueMain(record, "plain again");
+		uiQueueMainKeyed(&reposted, recordLast, "keyed again", NULL);
+	}
+}
+
+static void queuePostDuringCallback(void **state)
+{
+	const char *want[] = { "keyed", "b", "plain again", "keyed again" };
+
+	resetCalls();
+	reposted = 0;
+	// once a keyed call has started, posting its key again queues a new call behind everything already queued, instead of replacing the one that's running
+	uiQueueMainKeyed(&reposted, repost, "keyed", NULL);
+	uiQueueMain(record, "b");
+	unitMainUntil(&done);
+	assertCalls(want, 4);
+}
+
+static void queuePriorities(void **state)
+{
+	const char *want[] = { "high one", "high two", "normal", "background" };
+
+	resetCalls();
+	// queued lowest priority first, so running them in the order they were queued would fail
+	uiQueueMainWithPriority(uiQueuePriorityBackground, recordLast, "background");
+	uiQueueMainWithPriority(uiQueuePriorityNormal, record, "normal");
+	uiQueueMainWithPriority(uiQueuePriorityHigh, record, "high one");
+	uiQueueMainWithPriority(uiQueuePriorityHigh, record, "high two");
+	unitMainUntil(&done);
+	assertCalls(want, 4);
+}
+
+static void neverRun(void *data)
+{
+	fail_msg("a keyed call ran after uiUninit()");
+}
+
+static void queueUninitFreesKeyed(void **state)
+{
+	uiInitOptions o = {0};
+
+	assert_null(uiInit(&o));
+	nFreed = 0;
+	uiQueueMainKeyed(&nFreed, neverRun, (void *) values[0], countFree);
+	// the pending call is dropped, and its data freed; uiUninit() would report the call's own memory as a leak otherwise
+	uiUninit();
+	assert_int_equal(nFreed, 1);
+}
+
+int queueRunUnitTests(void)
+{
+	const struct CMUnitTest tests[] = {
+		cmocka_unit_test_setup_teardown(queueKeyedCoalesces, unitInitSetup, unitUninitTeardown),
+		cmocka_unit_test_setup_teardown(queueKeyedKeepsOrder, unitInitSetup, unitUninitTeardown),
+		cmocka_unit_test_setup_teardown(queuePostDuringCallback, unitInitSetup, unitUninitTeardown),
+		cmocka_unit_test_setup_teardown(queuePriorities, unitInitSetup, unitUninitTeardown),
+		cmocka_unit_test(queueUninitFreesKeyed),
+	};
+
+	return cmocka_run_group_tests_name("uiQueueMain", tests, NULL, NULL);
+}
@@ -0,0 +1,113 @@
+#include <glib.h>
+#include "unit.h"
+
+// these test the Unix scheduler; the other platforms don't enforce the budget or keep statistics yet (see ui.h)
+
+#define defaultBudget 4000
+#define defaultPeriod 16667
+
+struct job {
+	char name;
+	int slices;
+	int left;
+	// how long each slice takes, in microseconds
+	gulong sleep;
+	gint64 *at;
+};
+
+static char order[16];
+static int nOrder;
+static int jobsLeft;
+
+static int runSlice(void *data)
+{
+	struct job *j = (struct job *) data;
+
+	if (j->at != NULL)
+		j->at[j->slices] = g_get_monotonic_time();
+	if (nOrder < (int) sizeof (order))
+		order[nOrder++] = j->name;
+	j->slices++;
+	if (j->sleep != 0)
+		g_usleep(j->sleep);
+	j->left--;
+	if (j->left == 0) {
+		jobsLeft--;
+		return 0;
+	}
+	return 1;
+}
+
+static void schedulerRoundRobin(void **state)
+{
+	struct job a = { 'a', 0, 3, 0, NULL };
+	struct job b = { 'b', 0, 3, 0, NULL };
+
+	nOrder = 0;
+	jobsLeft = 2;
+	uiScheduleWork(runSlice, &a);
+	uiScheduleWork(runSlice, &b);
+	while (jobsLeft != 0)
+		uiMainStep(1);
+	assert_int_equal(nOrder, 6);
+	assert_memory_equal(order, "ababab", 6);
+}
+
+#define nSlices 40
+#define sliceTime 500
+#define budget 2000
+#define period 20000
+// a slice that's already running isn't cut off, so a period can go over the budget by one slice
+#define maxSlicesPerPeriod (budget / sliceTime + 1)
+
+static void schedulerBudget(void **state)
+{
+	gint64 at[nSlices];
+	struct job j = { 'j', 0, nSlices, sliceTime, at };
+	uiSchedulerStats s;
+	int i, inPeriod, nPeriods;
+
+	uiSchedulerSetBudget(budget, period);
+	nOrder = 0;
+	jobsLeft = 1;
+	uiScheduleWork(runSlice, &j);
+	uiSchedulerGetStats(&s);
+	assert_int_equal(s.PendingJobs, 1);
+	while (jobsLeft != 0)
+		uiMainStep(1);
+
+	// slices in the same period run back to back; between periods the scheduler waits out the rest of the period, which is much longer
+	inPeriod = 1;
+	nPeriods = 1;
+	for (i = 1; i < nSlices; i++) {
+		if (at[i] - at[i - 1] > (period - budget) / 2) {
+			nPeriods++;
+			inPeriod = 0;
+		}
+		inPeriod++;
+		assert_true(inPeriod <= maxSlicesPerPeriod);
+	}
+	assert_true(nPeriods >= nSlices / maxSlicesPerPeriod);
+
+	uiSchedulerGetStats(&s);
+	assert_int_equal(s.PendingJobs, 0);
+	assert_int_equal(s.CompletedJobs, 1);
+	assert_int_equal(s.Slices, nSlices);
+	assert_true(s.Periods >= (size_t) nPeriods);
+	assert_true(s.ExhaustedPeriods >= (size_t) (nPeriods - 1));
+	assert_true(s.BudgetMicroseconds == budget);
+	assert_true(s.TotalMicroseconds >= nSlices * sliceTime);
+	assert_true(s.LastPeriodMicroseconds > 0);
+
+	uiSchedulerSetBudget(defaultBudget, defaultPeriod);
+}
+
+int schedulerRunUnitTests(void)
+{
+	const struct CMUnitTest tests[] = {
+		cmocka_unit_test_setup_teardown(schedulerRoundRobin, unitInitSetup, unitUninitTeardown),
+		cmocka_unit_test_setup_teardown(schedulerBudget, unitInitSetup, unitUninitTeardown),
+	};
+
+	return cmocka_run_group_tests_name("uiScheduleWork", tests, NULL, NULL);
+}
@@ -0,0 +1,203 @@
+#include <glib.h>
+#include "unit.h"
+
+// these test the Unix timers; the other platforms have one native timer per uiTimerStart() and don't implement the fixed-rate modes
+// the timing checks fail if a timer fires early, or late enough to look like a different mode
+
+#define MS 1000
+
+struct ticks {
+	gint64 at[8];
+	int n;
+	int want;
+	int done;
+	// how long the first tick should take
+	gint64 firstSleep;
+};
+
+static int recordTick(void *data)
+{
+	struct ticks *t = (struct ticks *) data;
+
+	t->at[t->n] = g_get_monotonic_time();
+	t->n++;
+	if (t->n == 1 && t->firstSleep != 0)
+		g_usleep(t->firstSleep);
+	if (t->n == t->want) {
+		t->done = 1;
+		return 0;
+	}
+	return 1;
+}
+
+static int order[5];
+static int nOrder;
+static int orderDone;
+
+static int recordOrder(void *data)
+{
+	order[nOrder++] = GPOINTER_TO_INT(data);
+	if (nOrder == 5)
+		orderDone = 1;
+	return 0;
+}
+
+static void timerHeapOrder(void **state)
+{
+	const int ms[5] = { 30, 10, 50, 20, 40 };
+	int i;
+
+	nOrder = 0;
+	orderDone = 0;
+	for (i = 0; i < 5; i++)
+		uiTimerStart(ms[i], uiTimerModeFixedDelay, recordOrder, GINT_TO_POINTER(ms[i]));
+	unitMainUntil(&orderDone);
+	for (i = 0; i < 5; i++)
+		assert_int_equal(order[i], (i + 1) * 10);
+}
+
+static uiTimerID victim;
+static int victimRan;
+static int killerDone;
+
+static int killer(void *data)
+{
+	uiTimerCancel(victim);
+	killerDone = 1;
+	return 0;
+}
+
+static int countVictim(void *data)
+{
+	victimRan++;
+	return 1;
+}
+
+static void timerCancelFromCallback(void **state)
+{
+	struct ticks later = {0};
+
+	victimRan = 0;
+	killerDone = 0;
+	uiTimerStart(5, uiTimerModeFixedDelay, killer, NULL);
+	victim = uiTimerStart(6, uiTimerModeFixedDelay, countVictim, NULL);
+	// make both due in the same dispatch, so the victim is cancelled while it is next in line
+	g_usleep(20 * MS);
+	unitMainUntil(&killerDone);
+	// give the victim every chance to run
+	later.want = 1;
+	uiTimerStart(30, uiTimerModeFixedDelay, recordTick, &later);
+	unitMainUntil(&(later.done));
+	assert_int_equal(victimRan, 0);
+}
+
+struct rescheduled {
+	uiTimerID id;
+	struct ticks ticks;
+};
+
+static int rescheduleSelf(void *data)
+{
+	struct rescheduled *r = (struct rescheduled *) data;
+	int more;
+
+	more = recordTick(&(r->ticks));
+	if (r->ticks.n == 1)
+		uiTimerReschedule(r->id, 50);
+	return more;
+}
+
+static void timerRescheduleFromCallback(void **state)
+{
+	struct rescheduled r = {0};
+
+	r.ticks.want = 2;
+	r.id = uiTimerStart(5, uiTimerModeFixedDelay, rescheduleSelf, &r);
+	unitMainUntil(&(r.ticks.done));
+	assert_true(r.ticks.at[1] - r.ticks.at[0] >= 50 * MS);
+}
+
+static void timerFixedRatePhase(void **state)
+{
+	struct ticks t = {0};
+	gint64 start;
+
+	// the first tick, at 50 ms, overruns the second; fixed rate skips it and stays in phase, at 150 ms, where fixed delay would wait until 130 + 50 ms
+	t.want = 2;
+	t.firstSleep = 80 * MS;
+	start = g_get_monotonic_time();
+	uiTimerStart(50, uiTimerModeFixedRate, recordTick, &t);
+	unitMainUntil(&(t.done));
+	assert_true(t.at[1] - start >= 150 * MS);
+	assert_true(t.at[1] - start < 180 * MS);
+}
+
+static void timerFixedRateCatchUp(void **state)
+{
+	struct ticks t = {0};
+	gint64 start;
+
+	// the first tick overruns the next three, which then run back to back as soon as it returns, at about 90 ms; without catching up, the fourth tick would be at 140 ms
+	t.want = 4;
+	t.firstSleep = 70 * MS;
+	start = g_get_monotonic_time();
+	uiTimerStart(20, uiTimerModeFixedRateCatchUp, recordTick, &t);
+	unitMainUntil(&(t.done));
+	assert_true(t.at[3] - start >= 80 * MS);
+	assert_true(t.at[3] - start < 120 * MS);
+}
+
+static int nFast;
+static int fastDuringModal;
+static int modalDone;
+
+static int countFast(void *data)
+{
+	nFast++;
+	return 1;
+}
+
+static int modal(void *data)
+{
+	gint64 end;
+	int before;
+
+	// stand-in for a modal dialog
+	before = nFast;
+	end = g_get_monotonic_time() + 100 * MS;
+	while (g_get_monotonic_time() < end)
+		uiMainStep(1);
+	fastDuringModal = nFast - before;
+	modalDone = 1;
+	return 0;
+}
+
+static void timerNestedLoop(void **state)
+{
+	uiTimerID fast;
+
+	nFast = 0;
+	modalDone = 0;
+	uiTimerStart(10, uiTimerModeFixedDelay, modal, NULL);
+	fast = uiTimerStart(11, uiTimerModeFixedRate, countFast, NULL);
+	// make both due in the same dispatch, so the fast timer is waiting its turn when the modal loop starts
+	g_usleep(30 * MS);
+	unitMainUntil(&modalDone);
+	uiTimerCancel(fast);
+	// 100 ms of a 11 ms timer; leave plenty of room for a slow machine
+	assert_true(fastDuringModal >= 4);
+}
+
+int timerRunUnitTests(void)
+{
+	const struct CMUnitTest tests[] = {
+		cmocka_unit_test_setup_teardown(timerHeapOrder, unitInitSetup, unitUninitTeardown),
+		cmocka_unit_test_setup_teardown(timerCancelFromCallback, unitInitSetup, unitUninitTeardown),
+		cmocka_unit_test_setup_teardown(timerRescheduleFromCallback, unitInitSetup, unitUninitTeardown),
+		cmocka_unit_test_setup_teardown(timerFixedRatePhase, unitInitSetup, unitUninitTeardown),
+		cmocka_unit_test_setup_teardown(timerFixedRateCatchUp, unitInitSetup, unitUninitTeardown),
+		cmocka_unit_test_setup_teardown(timerNestedLoop, unitInitSetup, unitUninitTeardown),
+	};
+
+	return cmocka_run_group_tests_name("uiTimerStart", tests, NULL, NULL);
+}
@@ -25,6 +25,19 @@ int entryRunUnitTests(void);
 int menuRunUnitTests(void);
 int progressBarRunUnitTests(void);
 int drawMatrixRunUnitTests(void);
+#if !defined(_WIN32) && !defined(__APPLE__)
+int drawImageRunUnitTests(void);
+int drawPathRunUnitTests(void);
+int drawBrushRunUnitTests(void);
+int workerRunUnitTests(void);
+int timerRunUnitTests(void);
+int queueRunUnitTests(void);
+int allocRunUnitTests(void);
+int schedulerRunUnitTests(void);
+int watchdogRunUnitTests(void);
+int fdWatchRunUnitTests(void);
+int damageRunUnitTests(void);
+#endif
 
 /**
  * Helper for general setup/teardown of controls embedded in a window.
@@ -65,5 +78,19 @@ int unitTestTeardown(void **state);
 
 #define uiControlPtrFromState(t, s) (t**)&(((struct state *)*(s))->c)
 
+/**
+ * Helpers for tests that need uiInit() and the main loop but no window.
+ *
+ * unitInitSetup() also calls uiMainSteps(), so tests can run the main loop
+ * with uiMainStep() or unitMainUntil().
+ */
+int unitInitSetup(void **state);
+int unitUninitTeardown(void **state);
+
+/**
+ * Runs the main loop until @p done is set by one of the callbacks it runs.
+ */
+void unitMainUntil(const int *done);
+
 #endif
 
@@ -0,0 +1,181 @@
+#include <glib.h>
+#include "unit.h"
+
+// these test the Unix watchdog; the other platforms don't have one yet (see ui.h)
+
+#define threshold 40
+// long enough past the threshold that the watchdog, which checks every quarter of the threshold, can't miss it
+#define stallTime (150 * 1000)
+
+// the watchdog calls back on its own thread
+struct reports {
+	GMutex lock;
+	int n;
+	const char *dispatch[2];
+	double ms[2];
+	int ended[2];
+};
+
+static void recordStall(const char *dispatch, double stalledMilliseconds, int ended, void *data)
+{
+	struct reports *r = (struct reports *) data;
+
+	g_mutex_lock(&(r->lock));
+	if (r->n < 2) {
+		r->dispatch[r->n] = dispatch;
+		r->ms[r->n] = stalledMilliseconds;
+		r->ended[r->n] = ended;
+	}
+	r->n++;
+	g_mutex_unlock(&(r->lock));
+}
+
+static int reportsMade(struct reports *r)
+{
+	int n;
+
+	g_mutex_lock(&(r->lock));
+	n = r->n;
+	g_mutex_unlock(&(r->lock));
+	return n;
+}
+
+struct waitReports {
+	struct reports *r;
+	int want;
+	int done;
+};
+
+// keeps the main loop waking up until the watchdog has reported the end of the stall
+static int waitForReports(void *data)
+{
+	struct waitReports *w = (struct waitReports *) data;
+
+	if (reportsMade(w->r) < w->want)
+		return 1;
+	w->done = 1;
+	return 0;
+}
+
+static void runUntilReports(struct reports *r, int want)
+{
+	struct waitReports w;
+
+	w.r = r;
+	w.want = want;
+	w.done = 0;
+	uiTimerStart(5, uiTimerModeFixedDelay, waitForReports, &w);
+	unitMainUntil(&(w.done));
+}
+
+static void assertStall(struct reports *r, const char *dispatch)
+{
+	assert_int_equal(r->n, 2);
+	assert_false(r->ended[0]);
+	assert_true(r->ended[1]);
+	if (dispatch == NULL) {
+		assert_null(r->dispatch[0]);
+		assert_null(r->dispatch[1]);
+	} else {
+		assert_string_equal(r->dispatch[0], dispatch);
+		assert_string_equal(r->dispatch[1], dispatch);
+	}
+	assert_true(r->ms[0] >= threshold);
+	// the end of the stall reports the whole stall
+	assert_true(r->ms[1] >= r->ms[0]);
+	assert_true(r->ms[1] >= stallTime / 1000 - threshold);
+}
+
+static int stallingTimer(void *data)
+{
+	g_usleep(stallTime);
+	return 0;
+}
+
+static void watchdogStallInTimer(void **state)
+{
+	struct reports r = {0};
+
+	g_mutex_init(&(r.lock));
+	uiWatchdogStart(threshold, recordStall, &r);
+	uiTimerStart(1, uiTimerModeFixedDelay, stallingTimer, NULL);
+	runUntilReports(&r, 2);
+	uiWatchdogStop();
+	assertStall(&r, "uiTimer() callback");
+	g_mutex_clear(&(r.lock));
+}
+
+static void watchdogStallOutsideDispatch(void **state)
+{
+	struct reports r = {0};
+
+	g_mutex_init(&(r.lock));
+	uiWatchdogStart(threshold, recordStall, &r);
+	// the main loop has to have run once for a stall to count
+	uiMainStep(0);
+	// stand-in for a program doing its own work between uiMainStep() calls
+	g_usleep(stallTime);
+	runUntilReports(&r, 2);
+	uiWatchdogStop();
+	assertStall(&r, NULL);
+	g_mutex_clear(&(r.lock));
+}
+
+struct shortTicks {
+	int left;
+	int done;
+};
+
+static int shortTick(void *data)
+{
+	struct shortTicks *t = (struct shortTicks *) data;
+
+	g_usleep(2 * 1000);
+	t->left--;
+	if (t->left == 0) {
+		t->done = 1;
+		return 0;
+	}
+	return 1;
+}
+
+static void watchdogNoStall(void **state)
+{
+	struct reports r = {0};
+	struct shortTicks t = { 20, 0 };
+
+	g_mutex_init(&(r.lock));
+	// short callbacks, and the time spent waiting between them, aren't stalls
+	uiWatchdogStart(threshold, recordStall, &r);
+	uiTimerStart(threshold, uiTimerModeFixedDelay, shortTick, &t);
+	unitMainUntil(&(t.done));
+	uiWatchdogStop();
+	assert_int_equal(r.n, 0);
+	g_mutex_clear(&(r.lock));
+}
+
+static void watchdogStop(void **state)
+{
+	struct reports r = {0};
+
+	g_mutex_init(&(r.lock));
+	uiWatchdogStart(threshold, recordStall, &r);
+	uiMainStep(0);
+	uiWatchdogStop();
+	g_usleep(stallTime);
+	uiMainStep(0);
+	assert_int_equal(r.n, 0);
+	g_mutex_clear(&(r.lock));
+}
+
+int watchdogRunUnitTests(void)
+{
+	const struct CMUnitTest tests[] = {
+		cmocka_unit_test_setup_teardown(watchdogStallInTimer, unitInitSetup, unitUninitTeardown),
+		cmocka_unit_test_setup_teardown(watchdogStallOutsideDispatch, unitInitSetup, unitUninitTeardown),
+		cmocka_unit_test_setup_teardown(watchdogNoStall, unitInitSetup, unitUninitTeardown),
+		cmocka_unit_test_setup_teardown(watchdogStop, unitInitSetup, unitUninitTeardown),
+	};
+
+	return cmocka_run_group_tests_name("uiWatchdogStart", tests, NULL, NULL);
+}
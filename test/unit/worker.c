@@ -0,0 +1,157 @@
+#include <glib.h>
+#include "unit.h"
+
+// these test the Unix worker pool; the other platforms hand the jobs to the system thread pool
+
+struct workerState {
+	GThread *workThread;
+	GThread *doneThread;
+	int worked;
+	int cancelled;
+	int done;
+};
+
+static void recordWork(uiCancelToken *t, void *data)
+{
+	struct workerState *s = (struct workerState *) data;
+
+	s->workThread = g_thread_self();
+	s->worked = 1;
+}
+
+static void recordDone(int cancelled, void *data)
+{
+	struct workerState *s = (struct workerState *) data;
+
+	s->doneThread = g_thread_self();
+	s->cancelled = cancelled;
+	s->done = 1;
+}
+
+static void workerDoneOnMainThread(void **state)
+{
+	struct workerState s = {0};
+
+	uiWorkerSubmit(NULL, recordWork, recordDone, &s);
+	unitMainUntil(&(s.done));
+	assert_true(s.worked);
+	assert_false(s.cancelled);
+	assert_ptr_not_equal(s.workThread, g_thread_self());
+	assert_ptr_equal(s.doneThread, g_thread_self());
+}
+
+static void workerCancelledBeforeStart(void **state)
+{
+	struct workerState s = {0};
+	uiCancelToken *t;
+
+	t = uiNewCancelToken();
+	uiCancelTokenCancel(t);
+	uiWorkerSubmit(t, recordWork, recordDone, &s);
+	// the job keeps the token alive
+	uiFreeCancelToken(t);
+	unitMainUntil(&(s.done));
+	assert_false(s.worked);
+	assert_true(s.cancelled);
+	assert_ptr_equal(s.doneThread, g_thread_self());
+}
+
+// enough jobs that some are still waiting while every worker is held at the gate, on any machine we're likely to run on
+#define nGated 256
+
+static GMutex gateLock;
+static GCond gateCond;
+static gboolean gateOpen;
+static gint started;
+static int nDone;
+static int allDone;
+
+static void gatedWork(uiCancelToken *t, void *data)
+{
+	g_atomic_int_inc(&started);
+	g_mutex_lock(&gateLock);
+	while (!gateOpen)
+		g_cond_wait(&gateCond, &gateLock);
+	g_mutex_unlock(&gateLock);
+}
+
+static void gatedDone(int cancelled, void *data)
+{
+	nDone++;
+	if (nDone == nGated)
+		allDone = 1;
+}
+
+static void submitGated(void)
+{
+	int i;
+
+	gateOpen = FALSE;
+	started = 0;
+	nDone = 0;
+	allDone = 0;
+	for (i = 0; i < nGated; i++)
+		uiWorkerSubmit(NULL, gatedWork, gatedDone, NULL);
+}
+
+static void openGate(void)
+{
+	g_mutex_lock(&gateLock);
+	gateOpen = TRUE;
+	g_cond_broadcast(&gateCond);
+	g_mutex_unlock(&gateLock);
+}
+
+// returns the number of jobs that started, once every worker is stuck at the gate
+static int waitForWorkers(void)
+{
+	int n;
+
+	// a job is taken off the queue just before it counts itself as started, so wait for the two to add up
+	for (;;) {
+		n = g_atomic_int_get(&started);
+		if (n != 0 && n + uiWorkerQueueDepth() == nGated)
+			return n;
+		g_usleep(1000);
+	}
+}
+
+static void workerQueueDepth(void **state)
+{
+	int n;
+
+	assert_int_equal(uiWorkerQueueDepth(), 0);
+	submitGated();
+	n = waitForWorkers();
+	assert_true(n < nGated);
+	assert_int_equal(uiWorkerQueueDepth(), nGated - n);
+	openGate();
+	unitMainUntil(&allDone);
+	assert_int_equal(uiWorkerQueueDepth(), 0);
+}
+
+static void workerUninitWithJobsQueued(void **state)
+{
+	uiInitOptions o = {0};
+
+	assert_null(uiInit(&o));
+	submitGated();
+	waitForWorkers();
+	openGate();
+	// the jobs that haven't started are dropped, and nothing is leaked; uiUninit() would report it otherwise
+	uiUninit();
+	assert_int_equal(nDone, 0);
+	assert_int_equal(uiWorkerQueueDepth(), 0);
+}
+
+int workerRunUnitTests(void)
+{
+	const struct CMUnitTest tests[] = {
+		cmocka_unit_test_setup_teardown(workerDoneOnMainThread, unitInitSetup, unitUninitTeardown),
+		cmocka_unit_test_setup_teardown(workerCancelledBeforeStart, unitInitSetup, unitUninitTeardown),
+		cmocka_unit_test_setup_teardown(workerQueueDepth, unitInitSetup, unitUninitTeardown),
+		cmocka_unit_test(workerUninitWithJobsQueued),
+	};
+
+	return cmocka_run_group_tests_name("uiWorkerSubmit", tests, NULL, NULL);
+}
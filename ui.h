@@ -15,6 +15,8 @@
  * @defgroup dialogWindow Dialog windows
  * @defgroup menu Menus
  * @defgroup table Tables
+ * @defgroup memory Memory diagnostics
+ * @defgroup latency Latency diagnostics
  */
 
 #ifndef __LIBUI_UI_H__
@@ -70,8 +72,80 @@ _UI_EXTERN void uiMainSteps(void);
 _UI_EXTERN int uiMainStep(int wait);
 _UI_EXTERN void uiQuit(void);
 
+/**
+ * Queues a function to be run on the main thread.
+ *
+ * This is the only libui function that can be called from any thread
+ * at any time; use it to hand work done on other threads back to the UI.
+ *
+ * On Unix, the following objects can also be created, used and freed on
+ * other threads, as long as each object is only used by one thread at a
+ * time and isn't handed to a control or a draw context until it's back on
+ * the main thread:
+ * - uiAttributedString and uiAttribute
+ * - uiOpenTypeFeatures
+ * - uiDrawPath and uiDrawMatrix
+ * - uiImage
+ * - uiTableValue
+ *
+ * The one draw context that can be used off the main thread is that of a
+ * uiUnixDrawImage; see ui_unix.h for what can be drawn on it there.
+ * Everything else, including uiDrawTextLayout, must be used on the main
+ * thread only.
+ *
+ * @param f Function to run.
+ * @param data User data passed to @p f.
+ */
 _UI_EXTERN void uiQueueMain(void (*f)(void *data), void *data);
 
+/**
+ * Queues a function to be run on the main thread, replacing any call
+ * queued with the same key that hasn't run yet.
+ *
+ * Use this for updates where only the latest value matters, such as a
+ * progress bar or a label fed from a worker thread: no matter how often
+ * a key is posted, the main thread runs at most one call per key each
+ * time it drains the queue, always with the newest @p f and @p data.
+ * A call that gets replaced never runs; its data is passed to its
+ * @p freeData instead, if that isn't `NULL`.
+ *
+ * Can be called from any thread, like uiQueueMain().
+ *
+ * @param key Any pointer identifying the update, for example the control
+ *            it updates. Compared by address only.
+ * @param f Function to run.
+ * @param data User data passed to @p f.
+ * @param freeData Function to free @p data if the call is replaced
+ *                 before it runs, or `NULL`.
+ * @note Only Unix coalesces calls so far; on the other platforms this
+ *       behaves like uiQueueMain() and @p freeData is never called.
+ */
+_UI_EXTERN void uiQueueMainKeyed(const void *key, void (*f)(void *data), void *data, void (*freeData)(void *data));
+
+/**
+ * How urgently a function queued with uiQueueMainWithPriority() runs,
+ * relative to input handling and redrawing on the main thread.
+ */
+_UI_ENUM(uiQueuePriority) {
+	uiQueuePriorityHigh,		//!< Runs after pending input but before the next redraw. For latency-critical updates.
+	uiQueuePriorityNormal,		//!< Runs after the next redraw. This is what uiQueueMain() uses.
+	uiQueuePriorityBackground,	//!< Runs only when there is nothing else to do. For bulk work.
+};
+
+/**
+ * Queues a function to be run on the main thread with the given priority.
+ *
+ * Functions with the same priority run in the order they were queued.
+ * Can be called from any thread, like uiQueueMain().
+ *
+ * @param priority Priority of the call.
+ * @param f Function to run.
+ * @param data User data passed to @p f.
+ * @note Only Unix honors @p priority so far; on the other platforms this
+ *       behaves like uiQueueMain().
+ */
+_UI_EXTERN void uiQueueMainWithPriority(uiQueuePriority priority, void (*f)(void *data), void *data);
+
 // TODO standardize the looping behavior return type, either with some enum or something, and the test expressions throughout the code
 // TODO figure out what to do about looping and the exact point that the timer is rescheduled so we can document it; see https://github.com/andlabs/libui/pull/277
 // TODO (also in the above link) document that this cannot be called from any thread, unlike uiQueueMain()
@@ -80,6 +154,221 @@ _UI_EXTERN void uiQueueMain(void (*f)(void *data), void *data);
 // TODO also add a comment about how useful this could be in bindings, depending on the language being bound to
 _UI_EXTERN void uiTimer(int milliseconds, int (*f)(void *data), void *data);
 
+/**
+ * Identifies a timer started with uiTimerStart().
+ *
+ * `0` is never a valid timer.
+ */
+typedef uint32_t uiTimerID;
+
+/**
+ * How a timer started with uiTimerStart() schedules its next tick.
+ */
+_UI_ENUM(uiTimerMode) {
+	uiTimerModeFixedDelay,		//!< The next tick is one interval after the callback returns. This is what uiTimer() does.
+	uiTimerModeFixedRate,		//!< Ticks are one interval apart from the first one, no matter how long the callback takes. Ticks that were missed entirely are skipped.
+	uiTimerModeFixedRateCatchUp,	//!< Like uiTimerModeFixedRate, but ticks that were missed are run back to back, one per main loop iteration, until the timer is on schedule again.
+};
+
+/**
+ * Starts a timer that can be cancelled and rescheduled.
+ *
+ * Like uiTimer(), @p f is called every @p milliseconds until it returns `0`.
+ * Use the fixed-rate modes for animations and other things that must not
+ * drift.
+ *
+ * Must be called on the main thread.
+ *
+ * @param milliseconds Interval between ticks. Fractions of a millisecond are
+ *                     accepted, but the OS may not wake up any more precisely
+ *                     than once a millisecond.
+ * @param mode How the next tick is scheduled.
+ * @param f Function called on every tick. Return nonzero to keep the timer
+ *          running, or `0` to stop it.
+ * @param data User data passed to @p f.
+ * @returns ID of the new timer.
+ * @note Only Unix implements the fixed-rate modes so far; on the other
+ *       platforms every timer behaves like uiTimerModeFixedDelay.
+ */
+_UI_EXTERN uiTimerID uiTimerStart(double milliseconds, uiTimerMode mode, int (*f)(void *data), void *data);
+
+/**
+ * Stops a timer started with uiTimerStart().
+ *
+ * Does nothing if the timer has already stopped. Can be called from the
+ * timer's own callback.
+ *
+ * @param id ID of the timer.
+ */
+_UI_EXTERN void uiTimerCancel(uiTimerID id);
+
+/**
+ * Changes the interval of a timer started with uiTimerStart().
+ *
+ * The next tick happens @p milliseconds from now, and ticks keep the new
+ * interval after that. Does nothing if the timer has already stopped.
+ *
+ * @param id ID of the timer.
+ * @param milliseconds New interval.
+ */
+_UI_EXTERN void uiTimerReschedule(uiTimerID id, double milliseconds);
+
+/**
+ * Runs a long job on the main thread a slice at a time, without holding up
+ * input handling or redrawing.
+ *
+ * @p f is called repeatedly, interleaved with the other scheduled jobs,
+ * until it returns `0`. Each call should do a small, bounded piece of the
+ * job (for instance, add a few hundred rows to a table model) and return
+ * nonzero if there is more to do. Calls only happen while the main loop has
+ * no input or redraws pending, and stop for the rest of the current period
+ * once the time budget set with uiSchedulerSetBudget() is used up.
+ *
+ * Must be called on the main thread.
+ *
+ * @param f Function doing one slice of the job.
+ * @param data User data passed to @p f.
+ * @note Only Unix enforces the budget so far; on the other platforms jobs
+ *       run from a 1 ms uiTimer() and the statistics stay zero.
+ */
+_UI_EXTERN void uiScheduleWork(int (*f)(void *data), void *data);
+
+/**
+ * Sets how much time uiScheduleWork() jobs may take.
+ *
+ * Jobs get at most @p budgetMicroseconds of every @p periodMicroseconds.
+ * The default is 4000 microseconds every 16667 microseconds, a quarter of
+ * a frame at 60 frames per second. A slice that is already running is never
+ * interrupted, so a period's usage can exceed the budget by up to one slice.
+ *
+ * @param budgetMicroseconds Time budget per period, in microseconds.
+ * @param periodMicroseconds Length of a period, in microseconds. Must not be
+ *                           less than @p budgetMicroseconds.
+ */
+_UI_EXTERN void uiSchedulerSetBudget(int budgetMicroseconds, int periodMicroseconds);
+
+/**
+ * Statistics of the uiScheduleWork() scheduler since uiInit().
+ *
+ * @struct uiSchedulerStats
+ */
+typedef struct uiSchedulerStats uiSchedulerStats;
+struct uiSchedulerStats {
+	int PendingJobs;		//!< Number of jobs that haven't finished yet.
+	size_t CompletedJobs;		//!< Number of jobs that have finished.
+	size_t Slices;			//!< Number of times a job function was called.
+	size_t Periods;			//!< Number of periods in which jobs ran.
+	size_t ExhaustedPeriods;	//!< Number of those periods that used up the whole budget with work left over.
+	double BudgetMicroseconds;	//!< Current budget per period.
+	double LastPeriodMicroseconds;	//!< Time used by jobs in the most recent period in which they ran.
+	double TotalMicroseconds;	//!< Total time used by jobs.
+};
+
+/**
+ * Gets the statistics of the uiScheduleWork() scheduler.
+ *
+ * LastPeriodMicroseconds / BudgetMicroseconds is how much of the budget
+ * the scheduler is currently consuming; TotalMicroseconds / Periods is
+ * the average time used per period.
+ *
+ * @param[out] stats Statistics.
+ */
+_UI_EXTERN void uiSchedulerGetStats(uiSchedulerStats *stats);
+
+/**
+ * A flag for asking work submitted with uiWorkerSubmit() to stop early.
+ *
+ * Any number of jobs can share one token, and cancelling it cancels all of
+ * them. Tokens can be cancelled and checked from any thread.
+ *
+ * @struct uiCancelToken
+ */
+typedef struct uiCancelToken uiCancelToken;
+
+/**
+ * Creates a new cancellation token.
+ *
+ * @returns A new uiCancelToken instance.
+ * @memberof uiCancelToken @static
+ */
+_UI_EXTERN uiCancelToken *uiNewCancelToken(void);
+
+/**
+ * Frees a cancellation token.
+ *
+ * Jobs that were submitted with the token keep using it until their
+ * completion callbacks have run, so it is safe to free the token right
+ * after cancelling it.
+ *
+ * @param t uiCancelToken instance.
+ * @memberof uiCancelToken
+ */
+_UI_EXTERN void uiFreeCancelToken(uiCancelToken *t);
+
+/**
+ * Cancels every job submitted with the token.
+ *
+ * Jobs that haven't started yet are skipped; jobs that are running see
+ * uiCancelTokenCancelled() return nonzero and should stop as soon as they
+ * can. Either way their completion callbacks still run, with @p cancelled
+ * set. Cancelling cannot be undone.
+ *
+ * @param t uiCancelToken instance.
+ * @memberof uiCancelToken
+ */
+_UI_EXTERN void uiCancelTokenCancel(uiCancelToken *t);
+
+/**
+ * Returns whether the token has been cancelled.
+ *
+ * @param t uiCancelToken instance, or `NULL`.
+ * @returns `TRUE` if @p t has been cancelled, `FALSE` otherwise or if
+ *          @p t is `NULL`.
+ * @memberof uiCancelToken
+ */
+_UI_EXTERN int uiCancelTokenCancelled(uiCancelToken *t);
+
+/**
+ * Runs a job on a background thread, then a completion callback on the
+ * main thread.
+ *
+ * The job runs on a pool of worker threads, one per processor, which is
+ * started the first time this is called. Jobs may run in any order and in
+ * parallel with each other; a worker that runs out of jobs takes them from
+ * the others. @p work must not call libui functions other than those
+ * uiQueueMain() lists as safe to use off the main thread, plus
+ * uiWorkerSubmit() itself and the uiCancelToken functions.
+ *
+ * Once @p work returns (or is skipped because @p t was cancelled first),
+ * @p done is run on the main thread, where the result can be handed to the
+ * UI. Jobs that haven't finished when uiUninit() is called are dropped
+ * without running @p done.
+ *
+ * Can be called from any thread, including from @p work.
+ *
+ * @param t Cancellation token, or `NULL` for a job that can't be cancelled.
+ * @param work Function doing the job on a worker thread.
+ * @param done Function run on the main thread once the job is over, or `NULL`.\n
+ *             @p cancelled is `TRUE` if @p t was cancelled by the time
+ *             @p done runs, in which case @p work may not have run at all.
+ * @param data User data passed to @p work and @p done.
+ * @note On Windows and macOS, jobs run on the system thread pool (the
+ *       Windows thread pool and a global dispatch queue), which balances
+ *       them itself instead of using per-worker queues.
+ */
+_UI_EXTERN void uiWorkerSubmit(uiCancelToken *t, void (*work)(uiCancelToken *t, void *data), void (*done)(int cancelled, void *data), void *data);
+
+/**
+ * Returns the number of jobs submitted with uiWorkerSubmit() that haven't
+ * started yet.
+ *
+ * This can be used to hold off submitting more work while the pool is
+ * behind. Can be called from any thread.
+ *
+ * @returns Number of jobs waiting for a worker.
+ */
+_UI_EXTERN int uiWorkerQueueDepth(void);
+
 _UI_EXTERN void uiOnShouldQuit(int (*f)(void *data), void *data);
 
 
@@ -94,6 +383,220 @@ _UI_EXTERN void uiOnShouldQuit(int (*f)(void *data), void *data);
  */
 _UI_EXTERN void uiFreeText(char *text);
 
+/**
+ * Counters for one of libui's internal memory pools.
+ *
+ * libui allocates the small objects it creates and destroys in bulk, such as
+ * uiTableValue and the attribute entries of a uiAttributedString, from pools
+ * of fixed-size blocks. Reused / Allocations is the pool's reuse rate.
+ *
+ * @struct uiMemoryPoolStats
+ * @ingroup memory
+ */
+typedef struct uiMemoryPoolStats uiMemoryPoolStats;
+struct uiMemoryPoolStats {
+	size_t BlockSize;	//!< Size of each block in bytes, including any bookkeeping.
+	size_t Allocations;	//!< Number of blocks handed out so far.
+	size_t Reused;		//!< Number of those blocks that were recycled from freed ones.
+	size_t Live;		//!< Number of blocks currently in use.
+	size_t Chunks;		//!< Number of chunks the pool has carved its blocks from.
+};
+
+/**
+ * Returns the number of internal memory pools.
+ *
+ * @returns Number of pools. May be `0` on platforms that do not pool memory.
+ * @ingroup memory
+ */
+_UI_EXTERN int uiMemoryNumPools(void);
+
+/**
+ * Fills in the counters of an internal memory pool.
+ *
+ * @param n Index of the pool, from `0` to `uiMemoryNumPools() - 1`.
+ * @param[out] stats Counters of pool @p n.
+ * @ingroup memory
+ */
+_UI_EXTERN void uiMemoryGetPoolStats(int n, uiMemoryPoolStats *stats);
+
+/**
+ * Live memory statistics for one type of object allocated by libui.
+ *
+ * Only available on Unix when libui is built with allocation tracking (the
+ * `alloc_tracking` build option); otherwise no types are reported.
+ *
+ * @struct uiMemoryStats
+ * @ingroup memory
+ */
+typedef struct uiMemoryStats uiMemoryStats;
+struct uiMemoryStats {
+	const char *Type;		//!< Name of the type, e.g. `"uiTableValue"`.
+	size_t LiveBytes;		//!< Number of bytes currently allocated for this type.
+	size_t LiveCount;		//!< Number of objects of this type currently allocated.
+	size_t TotalAllocations;	//!< Number of objects of this type allocated so far.
+	size_t PeakBytes;		//!< Highest value LiveBytes has reached.
+};
+
+/**
+ * Function called by uiMemoryStatsForEach() for every type.
+ *
+ * @param s Statistics of the type. Only valid for the duration of the call.
+ * @param data User data passed to uiMemoryStatsForEach().
+ * @returns `uiForEachStop` to stop iterating, `uiForEachContinue` otherwise.
+ * @ingroup memory
+ */
+typedef uiForEach (*uiMemoryStatsForEachFunc)(const uiMemoryStats *s, void *data);
+
+/**
+ * Calls a function for the statistics of every type libui has allocated
+ * since uiInit(), in no particular order.
+ *
+ * @param f Function to call.
+ * @param data User data passed to @p f.
+ * @note @p f sees a snapshot of the statistics taken when
+ * uiMemoryStatsForEach() was called; it may allocate libui objects itself.
+ * @ingroup memory
+ */
+_UI_EXTERN void uiMemoryStatsForEach(uiMemoryStatsForEachFunc f, void *data);
+
+/**
+ * Prints the statistics of every type, largest first, followed by those
+ * of the memory pools, to standard error.
+ *
+ * Setting the `LIBUI_MEMORY_STATS` environment variable to a number of
+ * seconds before uiInit() prints them that often while the main loop runs.
+ *
+ * @ingroup memory
+ */
+_UI_EXTERN void uiMemoryDumpStats(void);
+
+/**
+ * What a latency histogram measures.
+ *
+ * @enum uiLatencyKind
+ * @ingroup latency
+ */
+_UI_ENUM(uiLatencyKind) {
+	uiLatencyKindQueueWait,		//!< Time between a uiQueueMain() call and the main thread running it.
+	uiLatencyKindQueuedCall,	//!< Time taken by functions queued with uiQueueMain() and its variants, including uiWorkerSubmit() done functions.
+	uiLatencyKindTimer,		//!< Time taken by uiTimer() and uiTimerStart() callbacks.
+	uiLatencyKindScheduledWork,	//!< Time taken by each slice of a uiScheduleWork() job.
+	uiLatencyKindDraw,		//!< Time taken by uiAreaHandler Draw handlers.
+	uiLatencyKindCellValue,		//!< Time taken by uiTableModelHandler CellValue handlers.
+	uiLatencyKindControlEvent,	//!< Time taken by control and window event handlers, such as OnChanged, OnClicked and OnClosing, by uiAreaHandler mouse and key handlers and uiAreaOnFrame() callbacks, by uiTableModelHandler SetCellValue handlers, and by uiOnShouldQuit() handlers.
+	uiLatencyKindFDWatch,		//!< Time taken by uiUnixWatchFD() callbacks. Unix only.
+};
+
+/** Number of buckets in a uiLatencyHistogram. @ingroup latency */
+#define uiLatencyHistogramBuckets 32
+
+/**
+ * A histogram of latencies or durations.
+ *
+ * Bucket `0` counts samples under 2 microseconds, and bucket `n` counts
+ * samples from 2^n up to 2^(n+1) microseconds; the last bucket also counts
+ * anything longer.
+ *
+ * @struct uiLatencyHistogram
+ * @ingroup latency
+ */
+typedef struct uiLatencyHistogram uiLatencyHistogram;
+struct uiLatencyHistogram {
+	size_t Count;					//!< Number of samples.
+	double TotalMicroseconds;			//!< Sum of all samples.
+	double MaxMicroseconds;				//!< Longest sample.
+	size_t Buckets[uiLatencyHistogramBuckets];	//!< Number of samples in each bucket.
+};
+
+/**
+ * Turns latency recording on or off.
+ *
+ * Recording is off by default, and costs nothing beyond a check per
+ * dispatch while it is. Turning it off keeps the histograms recorded so far.
+ * Must be called on the main thread.
+ *
+ * @param enable `TRUE` to record latencies, `FALSE` to stop.
+ * @note Only Unix records latencies so far; on the other platforms the
+ *       histograms stay empty.
+ * @ingroup latency
+ */
+_UI_EXTERN void uiLatencyEnable(int enable);
+
+/**
+ * Copies one of the latency histograms. Must be called on the main thread.
+ *
+ * @param kind Histogram to copy.
+ * @param[out] h Histogram.
+ * @ingroup latency
+ */
+_UI_EXTERN void uiLatencyGetHistogram(uiLatencyKind kind, uiLatencyHistogram *h);
+
+/**
+ * Empties all of the latency histograms. Must be called on the main thread.
+ *
+ * @ingroup latency
+ */
+_UI_EXTERN void uiLatencyReset(void);
+
+/**
+ * Prints a summary of every latency histogram, with its mean, approximate
+ * percentiles and maximum, to standard error.
+ *
+ * Setting the `LIBUI_LATENCY` environment variable to a number of seconds
+ * before uiInit() turns recording on and prints the summary that often
+ * while the main loop runs.
+ *
+ * @ingroup latency
+ */
+_UI_EXTERN void uiLatencyDump(void);
+
+/**
+ * Starts a watchdog thread that reports when the main loop stalls.
+ *
+ * The main loop is stalled when it hasn't gone back to waiting for events
+ * for @p thresholdMilliseconds, because something on the main thread is
+ * taking too long: a handler, a queued function, a timer, or the program's
+ * own code between uiMainStep() calls. The report says which libui
+ * dispatch was running, such as `"uiAreaHandler Draw"`,
+ * `"uiTableModelHandler CellValue"`, `"uiTimer() callback"` or
+ * `"uiQueueMain() function"`.
+ *
+ * If @p f is `NULL`, stalls are printed to standard error. Otherwise @p f
+ * is called on the watchdog thread once when a stall passes the threshold,
+ * and once more when the main loop gets going again. Since the main thread
+ * is stuck when @p f runs, @p f must not wait for it, and must not call
+ * uiWatchdogStop().
+ *
+ * Calling this again replaces the previous watchdog. Setting the
+ * `LIBUI_WATCHDOG` environment variable to a number of milliseconds before
+ * uiInit() starts a watchdog that prints stalls to standard error.
+ * Must be called on the main thread.
+ *
+ * @param thresholdMilliseconds How long the main loop can be busy before it
+ *                              counts as stalled. Stalls are noticed within
+ *                              a quarter of this.
+ * @param f Callback, or `NULL` to print stalls.\n
+ *          @p dispatch is the innermost libui dispatch that was running when
+ *          the stall passed the threshold, or `NULL` if there was none.\n
+ *          @p stalledMilliseconds is how long the main loop had been
+ *          stalled.\n
+ *          @p ended is `FALSE` when the stall is noticed and `TRUE` when
+ *          it is over.
+ * @param data User data passed to @p f.
+ * @note Only Unix has a watchdog so far. On Windows and macOS this does
+ *       nothing, and @p f is never called.
+ * @ingroup latency
+ */
+_UI_EXTERN void uiWatchdogStart(int thresholdMilliseconds, void (*f)(const char *dispatch, double stalledMilliseconds, int ended, void *data), void *data);
+
+/**
+ * Stops the watchdog started with uiWatchdogStart(), if any.
+ * Must be called on the main thread.
+ *
+ * @ingroup latency
+ */
+_UI_EXTERN void uiWatchdogStop(void);
+
 
 /**
  * Base class for GUI controls providing common methods.
@@ -2039,9 +2542,86 @@ _UI_ENUM(uiWindowResizeEdge) {
 // TODO give a better name
 // TODO document the types of width and height
 _UI_EXTERN void uiAreaSetSize(uiArea *a, int width, int height);
-// TODO uiAreaQueueRedraw()
 _UI_EXTERN void uiAreaQueueRedrawAll(uiArea *a);
+
+/**
+ * A rectangle in the coordinate space of a uiArea.
+ *
+ * @struct uiAreaRect
+ */
+typedef struct uiAreaRect uiAreaRect;
+struct uiAreaRect {
+	double X;	//!< X coordinate of the top left corner.
+	double Y;	//!< Y coordinate of the top left corner.
+	double Width;	//!< Width.
+	double Height;	//!< Height.
+};
+
+/**
+ * Queues a redraw of part of the area.
+ *
+ * Only the pixels touched by the rectangle are redrawn, and the Draw
+ * handler's clip is set to them, so updating something small (a cursor, a
+ * cell, a data point) doesn't repaint the whole area. Redraws queued before
+ * the next frame are combined.
+ *
+ * For scrolling areas the rectangle is in the same coordinates as drawing,
+ * that is, relative to the whole scrollable content, not to the visible part
+ * of it. Parts of the rectangle outside the area are ignored.
+ *
+ * @param a uiArea instance.
+ * @param x X coordinate of the top left corner.
+ * @param y Y coordinate of the top left corner.
+ * @param width Width. Nothing is redrawn if this is not positive.
+ * @param height Height. Nothing is redrawn if this is not positive.
+ * @note Only Unix redraws just the rectangle so far; on the other platforms
+ *       the whole area is redrawn.
+ * @memberof uiArea
+ */
+_UI_EXTERN void uiAreaQueueRedrawRect(uiArea *a, double x, double y, double width, double height);
+
+/**
+ * Queues a redraw of several parts of the area at once.
+ *
+ * This is the same as calling uiAreaQueueRedrawRect() for every rectangle,
+ * but the rectangles are merged into a single region first.
+ *
+ * @param a uiArea instance.
+ * @param rects Rectangles to redraw.
+ * @param n Number of rectangles in @p rects.
+ * @note Only Unix redraws just the rectangles so far; on the other
+ *       platforms the whole area is redrawn.
+ * @memberof uiArea
+ */
+_UI_EXTERN void uiAreaQueueRedrawRects(uiArea *a, const uiAreaRect *rects, int n);
 _UI_EXTERN void uiAreaScrollTo(uiArea *a, double x, double y, double width, double height);
+
+/**
+ * Registers a callback to be run once per frame, in step with the display,
+ * for animating the area.
+ *
+ * @p f runs right before the window is redrawn for every frame, for as long
+ * as it returns nonzero. It should update the animation for @p presentationTime
+ * and queue redraws of whatever changed; frames where nothing
+ * changed then cost no drawing at all.
+ *
+ * The callback stops when it returns `0`, when the area is hidden, when
+ * uiAreaOnFrame() is called again, or when it is called with a `NULL` @p f.
+ * Only one callback can be registered per area.
+ *
+ * @param a uiArea instance.
+ * @param f Callback, or `NULL` to stop the current one.\n
+ *          @p frameTime is when the frame started, in milliseconds.\n
+ *          @p presentationTime is when the frame is predicted to be shown,
+ *          in milliseconds on the same clock. If the OS can't predict it,
+ *          this is the same as @p frameTime.
+ * @param data User data passed to @p f.
+ * @note On Windows and macOS, frames are timed with a 60 Hz uiTimerStart()
+ *       timer for now, frame times count from when @p f was registered, and
+ *       hiding the area does not stop the callback.
+ * @memberof uiArea
+ */
+_UI_EXTERN void uiAreaOnFrame(uiArea *a, int (*f)(uiArea *a, double frameTime, double presentationTime, void *data), void *data);
 // TODO document these can only be called within Mouse() handlers
 // TODO should these be allowed on scrolling areas?
 // TODO decide which mouse events should be accepted; Down is the only one guaranteed to work right now
@@ -2063,6 +2643,13 @@ struct uiAreaDrawParams {
 	double ClipY;
 	double ClipWidth;
 	double ClipHeight;
+
+	// DamageRects lists the rectangles being redrawn; ClipX, ClipY, ClipWidth and ClipHeight are their bounding box.
+	// Anything drawn outside of them is thrown away, so a handler can skip it; see also uiDrawIntersectsDamage().
+	// The list is owned by libui and only valid until the handler returns.
+	// Only Unix lists the separate rectangles so far; on Windows and macOS NumDamageRects is always 1 and the one rectangle is the bounding box.
+	const uiAreaRect *DamageRects;
+	int NumDamageRects;
 };
 
 typedef struct uiDrawPath uiDrawPath;
@@ -2187,12 +2774,83 @@ _UI_EXTERN void uiDrawPathCloseFigure(uiDrawPath *p);
 // TODO effect of these when a figure is already started
 _UI_EXTERN void uiDrawPathAddRectangle(uiDrawPath *p, double x, double y, double width, double height);
 
+// These add many figures from one array, for plots and other large data sets; on Unix they write straight into the path with no per-point call. All of them do nothing if n is 0.
+// uiDrawPathAddPolyline() starts a new figure at the first of n points and draws lines through the rest; xy holds the points as x0, y0, x1, y1, and so on.
+_UI_EXTERN void uiDrawPathAddPolyline(uiDrawPath *p, const double *xy, int n);
+// uiDrawPathAddPolygon() is uiDrawPathAddPolyline() followed by uiDrawPathCloseFigure().
+_UI_EXTERN void uiDrawPathAddPolygon(uiDrawPath *p, const double *xy, int n);
+// uiDrawPathAddRectangles() adds n rectangles, as if by uiDrawPathAddRectangle(); xywh holds them as x0, y0, width0, height0, x1, and so on.
+_UI_EXTERN void uiDrawPathAddRectangles(uiDrawPath *p, const double *xywh, int n);
+// uiDrawPathAddCircles() adds n circles, each its own closed figure; xyr holds them as xCenter0, yCenter0, radius0, xCenter1, and so on.
+_UI_EXTERN void uiDrawPathAddCircles(uiDrawPath *p, const double *xyr, int n);
+
 _UI_EXTERN int uiDrawPathEnded(uiDrawPath *p);
 _UI_EXTERN void uiDrawPathEnd(uiDrawPath *p);
 
+// uiDrawPathReset() empties a path, ended or not, so it can be built again with the same fill mode; the path keeps its memory, so a path rebuilt every frame doesn't reallocate once it has reached its largest size.
+_UI_EXTERN void uiDrawPathReset(uiDrawPath *p);
+// uiDrawPathReserve() makes room for n more uiDrawPathNewFigure() or uiDrawPathLineTo() calls, so a path whose size is known ahead of time is built without reallocating. It's only a hint; paths grow as needed either way.
+_UI_EXTERN void uiDrawPathReserve(uiDrawPath *p, int n);
+
 _UI_EXTERN void uiDrawStroke(uiDrawContext *c, uiDrawPath *path, uiDrawBrush *b, uiDrawStrokeParams *p);
 _UI_EXTERN void uiDrawFill(uiDrawContext *c, uiDrawPath *path, uiDrawBrush *b);
 
+/**
+ * A brush turned into a native pattern once, to be filled and stroked with
+ * any number of times, on any uiDrawContext.
+ *
+ * uiDrawFill() and uiDrawStroke() have to build a native pattern from their
+ * uiDrawBrush on every call, adding every gradient stop one at a time. A
+ * program that fills with the same gradients every frame can build them
+ * once with uiDrawNewCachedBrush() instead. Cached brushes are immutable;
+ * to change one, free it and make a new one.
+ *
+ * @struct uiDrawCachedBrush
+ */
+typedef struct uiDrawCachedBrush uiDrawCachedBrush;
+
+/**
+ * Creates a cached brush.
+ *
+ * @param b Brush to cache. It and its gradient stops are copied, so they
+ *          can be freed or changed afterward.
+ * @returns A new uiDrawCachedBrush instance.
+ * @note Only Unix builds the native pattern ahead of time so far; on the
+ *       other platforms, a cached brush is a copy of @p b that is handed to
+ *       uiDrawFill() and uiDrawStroke().
+ * @memberof uiDrawCachedBrush @static
+ */
+_UI_EXTERN uiDrawCachedBrush *uiDrawNewCachedBrush(uiDrawBrush *b);
+
+/**
+ * Frees a cached brush.
+ *
+ * @param cb uiDrawCachedBrush instance.
+ * @memberof uiDrawCachedBrush
+ */
+_UI_EXTERN void uiDrawFreeCachedBrush(uiDrawCachedBrush *cb);
+
+/**
+ * Fills a path with a cached brush, as uiDrawFill() does.
+ *
+ * @param c Drawing context.
+ * @param path Path to fill.
+ * @param cb uiDrawCachedBrush instance.
+ * @memberof uiDrawCachedBrush
+ */
+_UI_EXTERN void uiDrawCachedBrushFill(uiDrawContext *c, uiDrawPath *path, uiDrawCachedBrush *cb);
+
+/**
+ * Strokes a path with a cached brush, as uiDrawStroke() does.
+ *
+ * @param c Drawing context.
+ * @param path Path to stroke.
+ * @param cb uiDrawCachedBrush instance.
+ * @param p Stroke parameters.
+ * @memberof uiDrawCachedBrush
+ */
+_UI_EXTERN void uiDrawCachedBrushStroke(uiDrawContext *c, uiDrawPath *path, uiDrawCachedBrush *cb, uiDrawStrokeParams *p);
+
 // TODO primitives:
 // - rounded rectangles
 // - elliptical arcs
@@ -2217,6 +2875,140 @@ _UI_EXTERN void uiDrawClip(uiDrawContext *c, uiDrawPath *path);
 _UI_EXTERN void uiDrawSave(uiDrawContext *c);
 _UI_EXTERN void uiDrawRestore(uiDrawContext *c);
 
+/**
+ * Returns whether a rectangle touches the part of the area being redrawn.
+ *
+ * The rectangle is in the current coordinate system, with the current
+ * transform applied, so it can be the bounding box of whatever is about to
+ * be drawn. Drawing that fails this test would be thrown away anyway, so it
+ * can be skipped. Remember to include the width of strokes in the
+ * rectangle.
+ *
+ * @param c Drawing context.
+ * @param x X coordinate of the top left corner.
+ * @param y Y coordinate of the top left corner.
+ * @param width Width.
+ * @param height Height.
+ * @returns `TRUE` if the rectangle intersects one of the rectangles in
+ *          uiAreaDrawParams.DamageRects, `FALSE` otherwise. Always `TRUE`
+ *          for contexts that aren't drawing a uiArea.
+ * @note Only Unix tests against the damage so far; on Windows and macOS
+ *       this always returns `TRUE`, so nothing is skipped.
+ */
+_UI_EXTERN int uiDrawIntersectsDamage(uiDrawContext *c, double x, double y, double width, double height);
+
+/**
+ * An offscreen image that is drawn once and composited many times.
+ *
+ * Where a display list (uiUnixDrawDisplayList) replays its drawing
+ * operations, a layer keeps their rasterized result, so compositing it
+ * costs one blit no matter how complex its contents are. Use layers for
+ * content that is expensive to draw but rarely changes, such as map tiles
+ * or chart backgrounds:
+ *
+ * @code
+ * if (!uiDrawLayerValid(p->Context, layer)) {
+ * 	uiDrawLayerBegin(p->Context, layer);
+ * 	// draw the contents
+ * 	uiDrawLayerEnd(p->Context, layer);
+ * }
+ * uiDrawLayerDraw(p->Context, layer, NULL, 1.0);
+ * @endcode
+ *
+ * A layer keeps its contents until uiDrawLayerInvalidate() is called. On
+ * high-DPI displays, contents are kept for each device scale the layer has
+ * been drawn at, so a window moving between monitors doesn't force a redraw
+ * every time it crosses.
+ *
+ * @struct uiDrawLayer
+ */
+typedef struct uiDrawLayer uiDrawLayer;
+
+/**
+ * Creates a new layer.
+ *
+ * @param width Width of the layer in drawing units.
+ * @param height Height of the layer in drawing units.
+ * @returns A new uiDrawLayer instance, with no contents.
+ * @note Only Unix keeps layer contents so far; on the other platforms,
+ *       uiDrawLayerValid() always returns `0`, drawing between begin and end
+ *       goes straight to the context, and uiDrawLayerDraw() draws nothing.
+ * @memberof uiDrawLayer @static
+ */
+_UI_EXTERN uiDrawLayer *uiDrawNewLayer(double width, double height);
+
+/**
+ * Frees a layer and its contents.
+ *
+ * @param l uiDrawLayer instance.
+ * @memberof uiDrawLayer
+ */
+_UI_EXTERN void uiDrawFreeLayer(uiDrawLayer *l);
+
+/**
+ * Returns whether a layer has contents for a drawing context's device scale.
+ *
+ * @param c Drawing context.
+ * @param l uiDrawLayer instance.
+ * @returns `TRUE` if the layer can be drawn on @p c without being redrawn,
+ *          `FALSE` otherwise.
+ * @memberof uiDrawLayer
+ */
+_UI_EXTERN int uiDrawLayerValid(uiDrawContext *c, uiDrawLayer *l);
+
+/**
+ * Throws away a layer's contents, at every device scale.
+ *
+ * Call this when what the layer shows changes. It can be called at any
+ * time, not only from a Draw handler; follow it with a queued redraw.
+ *
+ * @param l uiDrawLayer instance.
+ * @memberof uiDrawLayer
+ */
+_UI_EXTERN void uiDrawLayerInvalidate(uiDrawLayer *l);
+
+/**
+ * Starts drawing a layer's contents.
+ *
+ * Until the matching uiDrawLayerEnd(), everything drawn on @p c goes into
+ * the layer, replacing what was there. The layer's origin is at `(0, 0)`;
+ * drawing starts with an identity transform and no clip, and anything
+ * outside the layer's size is cut off.
+ *
+ * @param c Drawing context.
+ * @param l uiDrawLayer instance.
+ * @memberof uiDrawLayer
+ */
+_UI_EXTERN void uiDrawLayerBegin(uiDrawContext *c, uiDrawLayer *l);
+
+/**
+ * Finishes drawing a layer's contents.
+ *
+ * A layer must be ended before the Draw handler that started it returns.
+ *
+ * @param c Drawing context.
+ * @param l uiDrawLayer instance.
+ * @memberof uiDrawLayer
+ */
+_UI_EXTERN void uiDrawLayerEnd(uiDrawContext *c, uiDrawLayer *l);
+
+/**
+ * Composites a layer onto a drawing context.
+ *
+ * The layer is drawn with its origin at the context's current origin,
+ * under the context's current transform followed by @p m if given, and
+ * clipped by the context's current clip. If the layer has no contents for
+ * the context's device scale, contents drawn at another scale are used,
+ * resampled; if it has none at all, nothing is drawn.
+ *
+ * @param c Drawing context.
+ * @param l uiDrawLayer instance.
+ * @param m Extra transform to apply, or `NULL`.
+ * @param opacity Opacity to composite with, from `0` to `1`.
+ * @memberof uiDrawLayer
+ */
+_UI_EXTERN void uiDrawLayerDraw(uiDrawContext *c, uiDrawLayer *l, uiDrawMatrix *m, double opacity);
+
 // bitmap API
 _UI_EXTERN uiDrawBitmap* uiDrawNewBitmap(uiDrawContext* c, int width, int height);
 _UI_EXTERN void uiDrawBitmapUpdate(uiDrawBitmap* bmp, const void* data);
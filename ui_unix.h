@@ -137,6 +137,66 @@ _UI_EXTERN uiUnixControl *uiUnixAllocControl(size_t n, uint32_t typesig, const c
 // uiUnixStrdupText() takes the given string and produces a copy of it suitable for being freed by uiFreeText().
 _UI_EXTERN char *uiUnixStrdupText(const char *);
 
+// uiUnixFDWatch watches a file descriptor (a socket, pipe, inotify instance, and so on) from the main loop itself, so reacting to it doesn't need a thread that blocks on it and then calls uiQueueMain().
+// The watch is polled by the same GMainContext as everything else, so uiMain() and uiMainStep() both wake up for it; a program that drives libui with uiMainStep() can add all of its own descriptors this way.
+typedef struct uiUnixFDWatch uiUnixFDWatch;
+
+_UI_ENUM(uiUnixFDCondition) {
+	uiUnixFDReadable = 1 << 0,
+	uiUnixFDWritable = 1 << 1,
+	// uiUnixFDError covers errors and hangups; it is always reported and never needs to be asked for.
+	uiUnixFDError = 1 << 2,
+};
+
+// uiUnixWatchFD() calls f on the main thread whenever fd is ready for any of conditions, a bitwise OR of uiUnixFDCondition values, for as long as f returns nonzero.
+// f is passed the conditions that are ready. Once f returns 0 or uiUnixFDWatchRemove() is called, the watch is freed. The watch doesn't own fd; close it after removing the watch.
+// Must be called on the main thread.
+_UI_EXTERN uiUnixFDWatch *uiUnixWatchFD(int fd, int conditions, int (*f)(uiUnixFDWatch *w, int fd, int conditions, void *data), void *data);
+// uiUnixFDWatchSetConditions() changes what the watch waits for; for instance, a program can watch for uiUnixFDWritable only while it has output queued.
+_UI_EXTERN void uiUnixFDWatchSetConditions(uiUnixFDWatch *w, int conditions);
+// uiUnixFDWatchRemove() stops and frees the watch. It can be called from the watch's own callback.
+_UI_EXTERN void uiUnixFDWatchRemove(uiUnixFDWatch *w);
+
+// uiUnixDrawImage is an in-memory image with a uiDrawContext on it, for drawing without a uiArea: batch rendering, thumbnails, server-side charts, and tests.
+// It doesn't need a display, or even uiInit(), and everything that can be drawn in a uiArea, including text layouts, can be drawn on it.
+// The pixels are 32-bit premultiplied ARGB in native byte order, one uint32_t per pixel, rows stride bytes apart.
+// An image can be drawn on from a thread other than the main thread, such as a uiWorkerSubmit() job, as long as each image is only used by one thread at a time. Off the main thread, only these are safe:
+// - creating, freeing, and reading back the image, and writing it out as a PNG
+// - filling, stroking, and clipping with paths, which can be built on the same thread (see uiQueueMain() in ui.h)
+// - solid and gradient brushes, uiDrawCachedBrush, transforms, saving and restoring, uiDrawBitmap, and uiDrawLayer
+// - recording and replaying a uiUnixDrawDisplayList that has no text in it
+// Text is main-thread only: uiDrawTextLayout and uiDrawText() go through GDK's Pango context whenever a display is open, and that isn't thread-safe.
+typedef struct uiUnixDrawImage uiUnixDrawImage;
+
+// uiUnixNewDrawImage() creates an image of the given size in pixels, starting out fully transparent.
+_UI_EXTERN uiUnixDrawImage *uiUnixNewDrawImage(int width, int height);
+// uiUnixNewDrawImageForData() creates an image that draws straight into data, which the caller owns and must keep alive until the image is freed. stride must be a multiple of 4 and at least width * 4.
+_UI_EXTERN uiUnixDrawImage *uiUnixNewDrawImageForData(uint8_t *data, int width, int height, int stride);
+_UI_EXTERN void uiUnixFreeDrawImage(uiUnixDrawImage *img);
+// uiUnixDrawImageContext() returns the image's drawing context. It stays valid until the image is freed, and can be drawn on any number of times.
+_UI_EXTERN uiDrawContext *uiUnixDrawImageContext(uiUnixDrawImage *img);
+// uiUnixDrawImageSetScale() makes one drawing unit cover scale pixels across and down, like a uiArea on a high-DPI monitor; the image stays the same size in pixels. Layers drawn on the image keep separate contents for each scale (see uiDrawLayer in ui.h).
+// The context's transform and clip start over, and scale can't be changed while a display list or layer is being drawn. It returns 0, and changes nothing, if cairo is older than 1.14, which can't scale.
+_UI_EXTERN int uiUnixDrawImageSetScale(uiUnixDrawImage *img, double scale);
+// uiUnixDrawImageData() returns the image's pixels, with everything drawn so far, and stores the stride in *stride. The pointer stays valid until the image is freed; read from it, but don't write to it.
+_UI_EXTERN uint8_t *uiUnixDrawImageData(uiUnixDrawImage *img, int *stride);
+// uiUnixDrawImageWritePNG() writes the image to filename as a PNG. It returns nonzero on success.
+_UI_EXTERN int uiUnixDrawImageWritePNG(uiUnixDrawImage *img, const char *filename);
+
+// uiUnixDrawDisplayList is a recording of drawing operations that can be replayed any number of times, on any uiDrawContext.
+// Recording static content such as grids, axes and backgrounds once and replaying it every frame costs one call instead of rebuilding every path, brush and text layout. Display lists are immutable once recorded.
+// Only the Unix backend can record drawing so far, so this is Unix-only until the other backends can too.
+typedef struct uiUnixDrawDisplayList uiUnixDrawDisplayList;
+
+// uiUnixDrawBeginDisplayList() starts recording a display list. Until the matching uiUnixDrawEndDisplayList(), everything drawn on c (fills, strokes, text, bitmaps, transforms, clips, saves and restores) goes into the display list instead of onto the context.
+// Recording starts with an identity transform and no clip, independent of the context's state. Recordings can be nested.
+_UI_EXTERN void uiUnixDrawBeginDisplayList(uiDrawContext *c);
+// uiUnixDrawEndDisplayList() finishes recording and returns the display list. Paths, brushes and text layouts used while recording can be freed once it returns. A display list must be ended before the Draw handler that started it returns.
+_UI_EXTERN uiUnixDrawDisplayList *uiUnixDrawEndDisplayList(uiDrawContext *c);
+// uiUnixDrawDisplayListDraw() replays dl under the context's current transform, followed by m if it isn't NULL, clipped by the context's current clip. Nothing is replayed if none of it would be inside the damage.
+_UI_EXTERN void uiUnixDrawDisplayListDraw(uiDrawContext *c, uiUnixDrawDisplayList *dl, uiDrawMatrix *m);
+_UI_EXTERN void uiUnixFreeDrawDisplayList(uiUnixDrawDisplayList *dl);
+
 #ifdef __cplusplus
 }
 #endif
@@ -2,83 +2,706 @@
 #include <string.h>
 #include "uipriv_unix.h"
 
-static GPtrArray *allocations;
-
 #define UINT8(p) ((uint8_t *) (p))
 #define PVOID(p) ((void *) (p))
-#define EXTRA (sizeof (size_t) + sizeof (const char **))
-#define DATA(p) PVOID(UINT8(p) + EXTRA)
-#define BASE(p) PVOID(UINT8(p) - EXTRA)
-#define SIZE(p) ((size_t *) (p))
-#define CCHAR(p) ((const char **) (p))
-#define TYPE(p) CCHAR(UINT8(p) + sizeof (size_t))
 
-void uiprivInitAlloc(void)
+// size-class pools for uiprivPoolAlloc()
+// each pool hands out blocks of one size, carved out of large chunks and recycled through a free list, so objects that are created and destroyed in bulk stay close together in memory and stop hitting the general-purpose allocator
+// the blocks include the allocation header, if any
+// pools can be used from any thread; so threads don't fight over a pool's lock, each thread keeps a small cache of blocks for every pool, and only locks the pool to refill its cache or to give back a batch when it's holding too many
+#define poolGranularity 16
+#define poolMaxBlock 256
+#define nPools (poolMaxBlock / poolGranularity)
+#define chunkSize 16384
+#define cacheBatch 32
+
+struct chunk {
+	struct chunk *next;
+};
+
+// keep blocks aligned as well as g_malloc() would
+#define chunkExtra ((sizeof (struct chunk) + poolGranularity - 1) / poolGranularity * poolGranularity)
+
+struct pool {
+	GMutex lock;
+	// free blocks are chained through their first pointer
+	void *free;
+	// the part of the newest chunk that has not been handed out yet
+	uint8_t *next;
+	uint8_t *end;
+	struct chunk *chunks;
+	// how many blocks are in thread caches or in use; the pool can only be freed when this is 0
+	size_t out;
+	uiMemoryPoolStats stats;
+};
+
+struct cache {
+	void *free;
+	size_t nFree;
+	// fresh blocks set aside for this cache that haven't been handed out yet
+	uint8_t *next;
+	uint8_t *end;
+	// what has happened since the pool's counters were last updated; these are added to the pool's counters whenever the cache locks the pool anyway
+	// only the cache's own thread changes these, but uiMemoryGetPoolStats() reads them from other threads, so they're only touched with atomic operations (see count() and counted())
+	gssize allocations;
+	gssize reused;
+	gssize live;
+};
+
+static struct pool pools[nPools];
+
+// each thread's caches, one per pool; every thread that has used a pool is in a list, so uiMemoryGetPoolStats() can count what the caches haven't added to their pools yet
+struct threadCaches {
+	struct threadCaches *prev;
+	struct threadCaches *next;
+	struct cache caches[nPools];
+};
+
+// the list is circular and starts at this sentinel, like the list of allocations below
+static struct threadCaches allCaches = { &allCaches, &allCaches };
+// when both are needed, take allCachesLock before a pool's lock
+static GMutex allCachesLock;
+
+static void freeCaches(gpointer data);
+static GPrivate cachesKey = G_PRIVATE_INIT(freeCaches);
+
+static struct pool *poolFor(size_t blockSize)
 {
-	allocations = g_ptr_array_new();
+	if (blockSize == 0 || blockSize > poolMaxBlock)
+		return NULL;
+	return &pools[(blockSize - 1) / poolGranularity];
 }
 
-static void uninitComplain(gpointer ptr, gpointer data)
+static size_t poolBlockSize(struct pool *p)
 {
-	char **str = (char **) data;
-	char *str2;
+	return ((size_t) (p - pools) + 1) * poolGranularity;
+}
 
-	if (*str == NULL)
-		*str = g_strdup("");
-	str2 = g_strdup_printf("%s%p %s\n", *str, ptr, *TYPE(ptr));
-	g_free(*str);
-	*str = str2;
+static struct cache *cacheFor(struct pool *p)
+{
+	struct threadCaches *tc;
+
+	tc = (struct threadCaches *) g_private_get(&cachesKey);
+	if (tc == NULL) {
+		tc = g_new0(struct threadCaches, 1);
+		g_mutex_lock(&allCachesLock);
+		tc->prev = allCaches.prev;
+		tc->next = &allCaches;
+		allCaches.prev->next = tc;
+		allCaches.prev = tc;
+		g_mutex_unlock(&allCachesLock);
+		g_private_set(&cachesKey, tc);
+	}
+	return &(tc->caches[p - pools]);
 }
 
-void uiprivUninitAlloc(void)
+static void count(gssize *counter, gssize n)
+{
+	g_atomic_pointer_add(counter, n);
+}
+
+static gssize counted(gssize *counter)
+{
+	return (gssize) g_atomic_pointer_get(counter);
+}
+
+// call with p->lock held
+static void addCounters(struct pool *p, struct cache *c)
+{
+	p->stats.Allocations += counted(&(c->allocations));
+	p->stats.Reused += counted(&(c->reused));
+	p->stats.Live += counted(&(c->live));
+	// no other thread can count anything in between, since c is ours
+	g_atomic_pointer_set(&(c->allocations), 0);
+	g_atomic_pointer_set(&(c->reused), 0);
+	g_atomic_pointer_set(&(c->live), 0);
+}
+
+static void refillCache(struct pool *p, struct cache *c)
+{
+	struct chunk *ch;
+	void *block;
+	size_t blockSize, n;
+
+	g_mutex_lock(&p->lock);
+	addCounters(p, c);
+	// prefer recycled blocks, which are more likely to still be in the processor cache
+	for (n = 0; n < cacheBatch && p->free != NULL; n++) {
+		block = p->free;
+		p->free = *((void **) block);
+		*((void **) block) = c->free;
+		c->free = block;
+	}
+	if (n == 0) {
+		blockSize = poolBlockSize(p);
+		if (p->next == NULL || (size_t) (p->end - p->next) < blockSize) {
+			ch = (struct chunk *) g_malloc(chunkSize);
+			ch->next = p->chunks;
+			p->chunks = ch;
+			p->next = UINT8(ch) + chunkExtra;
+			p->end = UINT8(ch) + chunkSize;
+			p->stats.Chunks++;
+		}
+		n = (size_t) (p->end - p->next) / blockSize;
+		if (n > cacheBatch)
+			n = cacheBatch;
+		c->next = p->next;
+		c->end = p->next + n * blockSize;
+		p->next = c->end;
+	} else
+		c->nFree += n;
+	p->out += n;
+	g_mutex_unlock(&p->lock);
+}
+
+// gives the first n free blocks of c back to p
+static void spillCache(struct pool *p, struct cache *c, size_t n)
 {
-	char *str = NULL;
+	void *first, *last;
+	size_t i;
+
+	first = NULL;
+	last = NULL;
+	if (n != 0) {
+		first = c->free;
+		last = first;
+		for (i = 1; i < n; i++)
+			last = *((void **) last);
+		c->free = *((void **) last);
+		c->nFree -= n;
+	}
+	g_mutex_lock(&p->lock);
+	addCounters(p, c);
+	if (n != 0) {
+		*((void **) last) = p->free;
+		p->free = first;
+		p->out -= n;
+	}
+	g_mutex_unlock(&p->lock);
+}
 
-	if (allocations->len == 0) {
-		g_ptr_array_free(allocations, TRUE);
+static void flushCache(struct pool *p, struct cache *c)
+{
+	size_t blockSize;
+	void *block;
+
+	// turn the fresh blocks into free ones so they can all go back together
+	blockSize = poolBlockSize(p);
+	while (c->next != c->end) {
+		block = c->next;
+		c->next += blockSize;
+		*((void **) block) = c->free;
+		c->free = block;
+		c->nFree++;
+	}
+	spillCache(p, c, c->nFree);
+	c->next = NULL;
+	c->end = NULL;
+}
+
+// runs when a thread that used a pool exits
+static void freeCaches(gpointer data)
+{
+	struct threadCaches *tc = (struct threadCaches *) data;
+	int i;
+
+	// flush before leaving the list, so the counters are always either in the cache or in the pool
+	for (i = 0; i < nPools; i++)
+		flushCache(&pools[i], &(tc->caches[i]));
+	g_mutex_lock(&allCachesLock);
+	tc->prev->next = tc->next;
+	tc->next->prev = tc->prev;
+	g_mutex_unlock(&allCachesLock);
+	g_free(tc);
+}
+
+static void *poolTake(struct pool *p)
+{
+	struct cache *c;
+	void *block;
+
+	c = cacheFor(p);
+	if (c->free == NULL && c->next == c->end)
+		refillCache(p, c);
+	count(&(c->allocations), 1);
+	count(&(c->live), 1);
+	if (c->free != NULL) {
+		block = c->free;
+		c->free = *((void **) block);
+		c->nFree--;
+		count(&(c->reused), 1);
+		return block;
+	}
+	block = c->next;
+	c->next += poolBlockSize(p);
+	return block;
+}
+
+static void poolGive(struct pool *p, void *block)
+{
+	struct cache *c;
+
+	// blocks can be given back on a different thread than the one that took them; they just join that thread's cache
+	c = cacheFor(p);
+	*((void **) block) = c->free;
+	c->free = block;
+	c->nFree++;
+	count(&(c->live), -1);
+	if (c->nFree >= 2 * cacheBatch)
+		spillCache(p, c, cacheBatch);
+}
+
+// leaked blocks still point into their chunks, so only let go of pools that are completely free
+// this also keeps pools whose blocks are still cached by threads that haven't exited yet
+static void uninitPools(void)
+{
+	struct threadCaches *tc;
+	struct pool *p;
+	struct chunk *c, *next;
+
+	tc = (struct threadCaches *) g_private_get(&cachesKey);
+	if (tc != NULL) {
+		g_private_set(&cachesKey, NULL);
+		freeCaches(tc);
+	}
+	for (p = pools; p < pools + nPools; p++) {
+		g_mutex_lock(&p->lock);
+		if (p->out == 0) {
+			for (c = p->chunks; c != NULL; c = next) {
+				next = c->next;
+				g_free(c);
+			}
+			p->free = NULL;
+			p->next = NULL;
+			p->end = NULL;
+			p->chunks = NULL;
+			memset(&(p->stats), 0, sizeof (uiMemoryPoolStats));
+		}
+		g_mutex_unlock(&p->lock);
+	}
+}
+
+int uiMemoryNumPools(void)
+{
+	return nPools;
+}
+
+void uiMemoryGetPoolStats(int n, uiMemoryPoolStats *s)
+{
+	struct threadCaches *tc;
+	struct cache *c;
+
+	if (n < 0 || n >= nPools)
+		uiprivUserBug("Invalid pool index %d passed to uiMemoryGetPoolStats(); valid indices are 0 to %d.", n, nPools - 1);
+	// add up what every cache hasn't handed to the pool yet, without touching the caches, so asking doesn't give the calling thread a cache of its own
+	// the pool's lock keeps a cache from moving its counters into the pool while we read them; other threads can still be counting an allocation in flight, so their part can be off by that much
+	g_mutex_lock(&allCachesLock);
+	g_mutex_lock(&(pools[n].lock));
+	*s = pools[n].stats;
+	for (tc = allCaches.next; tc != &allCaches; tc = tc->next) {
+		c = &(tc->caches[n]);
+		s->Allocations += counted(&(c->allocations));
+		s->Reused += counted(&(c->reused));
+		s->Live += counted(&(c->live));
+	}
+	g_mutex_unlock(&(pools[n].lock));
+	g_mutex_unlock(&allCachesLock);
+	s->BlockSize = poolBlockSize(&pools[n]);
+}
+
+#ifdef libui_NO_ALLOC_TRACKING
+
+// without allocation tracking (see the alloc_tracking build option), these map straight onto the GLib allocator: no header, no list, and no leak report
+// uiprivAlloc() still zero-fills because callers rely on it; uiprivRealloc() doesn't (see uipriv.h)
+// we never ask GLib for 0 bytes because it would return NULL, which uiprivFree() rejects
+
+static void uninitTracking(void)
+{
+	// do nothing
+}
+
+void *uiprivAlloc(size_t size, const char *type)
+{
+	if (size == 0)
+		size = 1;
+	return g_malloc0(size);
+}
+
+void *uiprivRealloc(void *p, size_t new, const char *type)
+{
+	if (p == NULL)
+		return uiprivAlloc(new, type);
+	if (new == 0)
+		new = 1;
+	return g_realloc(p, new);
+}
+
+void uiprivFree(void *p)
+{
+	if (p == NULL)
+		uiprivImplBug("attempt to uiprivFree(NULL)");
+	g_free(p);
+}
+
+void *uiprivPoolAlloc(size_t size, const char *type)
+{
+	struct pool *pool;
+	void *block;
+
+	pool = poolFor(size);
+	if (pool == NULL)
+		return uiprivAlloc(size, type);
+	block = poolTake(pool);
+	memset(block, 0, size);
+	return block;
+}
+
+void uiprivPoolFree(void *p, size_t size)
+{
+	struct pool *pool;
+
+	if (p == NULL)
+		uiprivImplBug("attempt to uiprivPoolFree(NULL)");
+	pool = poolFor(size);
+	if (pool == NULL) {
+		uiprivFree(p);
 		return;
 	}
-	g_ptr_array_foreach(allocations, uninitComplain, &str);
-	uiprivUserBug("Some data was leaked; either you left a uiControl lying around or there's a bug in libui itself. Leaked data:\n%s", str);
-	g_free(str);
+	poolGive(pool, p);
+}
+
+void uiMemoryStatsForEach(uiMemoryStatsForEachFunc f, void *data)
+{
+	// nothing is tracked, so there's nothing to report
+}
+
+#else
+
+// every allocation is prefixed with a header that links it into a list of all live allocations
+// the list is doubly-linked so adding and removing an allocation is O(1) no matter how many allocations are alive, while still letting uiprivUninitAlloc() report what leaked
+// the header also points to the statistics of the allocation's type, so those can be kept up to date without a lookup on every free
+struct header {
+	struct header *prev;
+	struct header *next;
+	size_t size;
+	uiMemoryStats *stats;
+};
+
+// the list is circular and starts at this sentinel, so adding and removing never has to special-case either end
+static struct header allocations = { &allocations, &allocations, 0, NULL };
+
+// allocLock protects the list and the statistics, so libui objects can be allocated and freed on any thread
+static GMutex allocLock;
+
+#define EXTRA (sizeof (struct header))
+#define DATA(h) PVOID(UINT8(h) + EXTRA)
+#define HEADER(p) ((struct header *) (UINT8(p) - EXTRA))
+
+// the top bit of the size marks allocations that came from a pool, so we can catch them being freed the wrong way
+#define POOLED (((size_t) 1) << (sizeof (size_t) * 8 - 1))
+
+// the same type name can show up as several different pointers if it's spelled out in several files, so statsByPointer maps each pointer we see to the one entry for its name in statsByName, which owns the entries
+static GHashTable *statsByPointer = NULL;
+static GHashTable *statsByName = NULL;
+
+static uiMemoryStats *statsFor(const char *type)
+{
+	uiMemoryStats *s;
+
+	if (statsByPointer == NULL) {
+		statsByPointer = g_hash_table_new(g_direct_hash, g_direct_equal);
+		statsByName = g_hash_table_new_full(g_str_hash, g_str_equal, NULL, g_free);
+	}
+	s = (uiMemoryStats *) g_hash_table_lookup(statsByPointer, type);
+	if (s != NULL)
+		return s;
+	s = (uiMemoryStats *) g_hash_table_lookup(statsByName, type);
+	if (s == NULL) {
+		s = g_new0(uiMemoryStats, 1);
+		s->Type = type;
+		g_hash_table_insert(statsByName, (gpointer) type, s);
+	}
+	g_hash_table_insert(statsByPointer, (gpointer) type, s);
+	return s;
+}
+
+static void countAlloc(uiMemoryStats *s, size_t size)
+{
+	s->LiveBytes += size;
+	s->LiveCount++;
+	s->TotalAllocations++;
+	if (s->LiveBytes > s->PeakBytes)
+		s->PeakBytes = s->LiveBytes;
+}
+
+static void countResize(uiMemoryStats *s, size_t old, size_t new)
+{
+	s->LiveBytes -= old;
+	s->LiveBytes += new;
+	if (s->LiveBytes > s->PeakBytes)
+		s->PeakBytes = s->LiveBytes;
+}
+
+static void countFree(uiMemoryStats *s, size_t size)
+{
+	s->LiveBytes -= size;
+	s->LiveCount--;
+}
+
+static void addAllocation(struct header *h)
+{
+	h->prev = allocations.prev;
+	h->next = &allocations;
+	allocations.prev->next = h;
+	allocations.prev = h;
+}
+
+static void removeAllocation(struct header *h, const char *func)
+{
+	// we can't find out if p was ever returned by uiprivAlloc() without a search, but we can at least make sure its neighbors agree that it's in the list
+	if (h->prev->next != h || h->next->prev != h)
+		uiprivImplBug("%p not found in allocations list in %s()", DATA(h), func);
+	h->prev->next = h->next;
+	h->next->prev = h->prev;
+	h->prev = NULL;
+	h->next = NULL;
+}
+
+static void uninitTracking(void)
+{
+	GString *str;
+	struct header *h;
+
+	g_mutex_lock(&allocLock);
+	if (allocations.next == &allocations) {
+		// start the next uiInit() with fresh statistics
+		if (statsByPointer != NULL) {
+			g_hash_table_destroy(statsByPointer);
+			g_hash_table_destroy(statsByName);
+			statsByPointer = NULL;
+			statsByName = NULL;
+		}
+		g_mutex_unlock(&allocLock);
+		return;
+	}
+	str = g_string_new("");
+	for (h = allocations.next; h != &allocations; h = h->next)
+		g_string_append_printf(str, "%p %s\n", DATA(h), h->stats->Type);
+	g_mutex_unlock(&allocLock);
+	uiprivUserBug("Some data was leaked; either you left a uiControl lying around or there's a bug in libui itself. Leaked data:\n%s", str->str);
+	g_string_free(str, TRUE);
 }
 
 void *uiprivAlloc(size_t size, const char *type)
 {
-	void *out;
+	struct header *h;
 
-	out = g_malloc0(EXTRA + size);
-	*SIZE(out) = size;
-	*TYPE(out) = type;
-	g_ptr_array_add(allocations, out);
-	return DATA(out);
+	h = (struct header *) g_malloc0(EXTRA + size);
+	h->size = size;
+	g_mutex_lock(&allocLock);
+	h->stats = statsFor(type);
+	countAlloc(h->stats, size);
+	addAllocation(h);
+	g_mutex_unlock(&allocLock);
+	return DATA(h);
 }
 
 void *uiprivRealloc(void *p, size_t new, const char *type)
 {
-	void *out;
-	size_t *s;
+	struct header *h;
+	size_t old;
 
 	if (p == NULL)
 		return uiprivAlloc(new, type);
-	p = BASE(p);
-	out = g_realloc(p, EXTRA + new);
-	s = SIZE(out);
-	if (new > *s)
-		memset(((uint8_t *) DATA(out)) + *s, 0, new - *s);
-	*s = new;
-	if (g_ptr_array_remove(allocations, p) == FALSE)
-		uiprivImplBug("%p not found in allocations array in uiprivRealloc()", p);
-	g_ptr_array_add(allocations, out);
-	return DATA(out);
+	h = HEADER(p);
+	if ((h->size & POOLED) != 0)
+		uiprivImplBug("attempt to uiprivRealloc() %p, which came from uiprivPoolAlloc()", p);
+	// take the allocation out of the list before g_realloc() moves it out from under its neighbors
+	// the lock has to be held until it's back in, since other threads could change its neighbors in the meantime
+	g_mutex_lock(&allocLock);
+	removeAllocation(h, "uiprivRealloc");
+	old = h->size;
+	h = (struct header *) g_realloc(h, EXTRA + new);
+	h->size = new;
+	countResize(h->stats, old, new);
+	addAllocation(h);
+	g_mutex_unlock(&allocLock);
+	if (new > old)
+		memset(UINT8(DATA(h)) + old, 0, new - old);
+	return DATA(h);
 }
 
 void uiprivFree(void *p)
 {
+	struct header *h;
+
 	if (p == NULL)
 		uiprivImplBug("attempt to uiprivFree(NULL)");
-	p = BASE(p);
-	g_free(p);
-	if (g_ptr_array_remove(allocations, p) == FALSE)
-		uiprivImplBug("%p not found in allocations array in uiprivFree()", p);
+	h = HEADER(p);
+	if ((h->size & POOLED) != 0)
+		uiprivImplBug("attempt to uiprivFree() %p, which came from uiprivPoolAlloc()", p);
+	g_mutex_lock(&allocLock);
+	removeAllocation(h, "uiprivFree");
+	countFree(h->stats, h->size);
+	g_mutex_unlock(&allocLock);
+	g_free(h);
+}
+
+void *uiprivPoolAlloc(size_t size, const char *type)
+{
+	struct pool *pool;
+	struct header *h;
+
+	pool = poolFor(EXTRA + size);
+	if (pool == NULL)
+		return uiprivAlloc(size, type);
+	h = (struct header *) poolTake(pool);
+	memset(h, 0, EXTRA + size);
+	h->size = size | POOLED;
+	g_mutex_lock(&allocLock);
+	h->stats = statsFor(type);
+	countAlloc(h->stats, size);
+	addAllocation(h);
+	g_mutex_unlock(&allocLock);
+	return DATA(h);
+}
+
+void uiprivPoolFree(void *p, size_t size)
+{
+	struct pool *pool;
+	struct header *h;
+
+	if (p == NULL)
+		uiprivImplBug("attempt to uiprivPoolFree(NULL)");
+	pool = poolFor(EXTRA + size);
+	if (pool == NULL) {
+		uiprivFree(p);
+		return;
+	}
+	h = HEADER(p);
+	if (h->size != (size | POOLED))
+		uiprivImplBug("attempt to uiprivPoolFree() %p with the wrong size %zu", p, size);
+	g_mutex_lock(&allocLock);
+	removeAllocation(h, "uiprivPoolFree");
+	countFree(h->stats, size);
+	g_mutex_unlock(&allocLock);
+	poolGive(pool, h);
+}
+
+void uiMemoryStatsForEach(uiMemoryStatsForEachFunc f, void *data)
+{
+	GHashTableIter iter;
+	gpointer value;
+	uiMemoryStats *all;
+	guint i, n;
+
+	// copy the entries out and call f without the lock held, so f is free to allocate libui objects (which takes allocLock) or take locks of its own
+	all = NULL;
+	n = 0;
+	g_mutex_lock(&allocLock);
+	if (statsByName != NULL) {
+		all = g_new(uiMemoryStats, g_hash_table_size(statsByName));
+		g_hash_table_iter_init(&iter, statsByName);
+		while (g_hash_table_iter_next(&iter, NULL, &value))
+			all[n++] = *((uiMemoryStats *) value);
+	}
+	g_mutex_unlock(&allocLock);
+	for (i = 0; i < n; i++)
+		if ((*f)(&all[i], data) == uiForEachStop)
+			break;
+	g_free(all);
+}
+
+#endif
+
+static gint compareLiveBytes(gconstpointer a, gconstpointer b)
+{
+	const uiMemoryStats *sa = (const uiMemoryStats *) a;
+	const uiMemoryStats *sb = (const uiMemoryStats *) b;
+
+	if (sa->LiveBytes > sb->LiveBytes)
+		return -1;
+	if (sa->LiveBytes < sb->LiveBytes)
+		return 1;
+	return strcmp(sa->Type, sb->Type);
+}
+
+// take copies, since the ones uiMemoryStatsForEach() passes are only valid for the duration of the call
+static uiForEach collectStats(const uiMemoryStats *s, void *data)
+{
+	g_array_append_vals((GArray *) data, s, 1);
+	return uiForEachContinue;
+}
+
+void uiMemoryDumpStats(void)
+{
+	GArray *all;
+	const uiMemoryStats *s;
+	uiMemoryPoolStats ps;
+	size_t bytes, count;
+	guint i;
+	int n;
+
+	all = g_array_new(FALSE, FALSE, sizeof (uiMemoryStats));
+	uiMemoryStatsForEach(collectStats, all);
+	g_array_sort(all, compareLiveBytes);
+	bytes = 0;
+	count = 0;
+	for (i = 0; i < all->len; i++) {
+		s = &g_array_index(all, uiMemoryStats, i);
+		bytes += s->LiveBytes;
+		count += s->LiveCount;
+	}
+#ifdef libui_NO_ALLOC_TRACKING
+	g_printerr("[libui] memory: allocation tracking is disabled; only pool statistics are available\n");
+#else
+	g_printerr("[libui] memory: %" G_GSIZE_FORMAT " bytes live in %" G_GSIZE_FORMAT " allocations\n", bytes, count);
+	g_printerr("[libui] %12s %10s %12s %12s  %s\n", "live bytes", "live", "total", "peak bytes", "type");
+	for (i = 0; i < all->len; i++) {
+		s = &g_array_index(all, uiMemoryStats, i);
+		g_printerr("[libui] %12" G_GSIZE_FORMAT " %10" G_GSIZE_FORMAT " %12" G_GSIZE_FORMAT " %12" G_GSIZE_FORMAT "  %s\n",
+			s->LiveBytes, s->LiveCount, s->TotalAllocations, s->PeakBytes, s->Type);
+	}
+#endif
+	g_array_free(all, TRUE);
+	for (n = 0; n < nPools; n++) {
+		uiMemoryGetPoolStats(n, &ps);
+		if (ps.Allocations == 0)
+			continue;
+		g_printerr("[libui] pool %4" G_GSIZE_FORMAT ": %" G_GSIZE_FORMAT " live, %" G_GSIZE_FORMAT " of %" G_GSIZE_FORMAT " allocations reused, %" G_GSIZE_FORMAT " chunks\n",
+			ps.BlockSize, ps.Live, ps.Reused, ps.Allocations, ps.Chunks);
+	}
+}
+
+// setting LIBUI_MEMORY_STATS to a number of seconds dumps the statistics that often, so you can watch a long-running program without stopping it
+static guint dumpTimer = 0;
+
+static gboolean periodicDump(gpointer data)
+{
+	uiMemoryDumpStats();
+	return TRUE;
+}
+
+void uiprivInitAlloc(void)
+{
+	const char *env;
+	int seconds;
+
+	env = g_getenv("LIBUI_MEMORY_STATS");
+	if (env == NULL)
+		return;
+	seconds = atoi(env);
+	if (seconds <= 0)
+		return;
+	dumpTimer = g_timeout_add_seconds(seconds, periodicDump, NULL);
+}
+
+void uiprivUninitAlloc(void)
+{
+	if (dumpTimer != 0) {
+		g_source_remove(dumpTimer);
+		dumpTimer = 0;
+	}
+	uninitTracking();
+	uninitPools();
 }
@@ -49,6 +49,11 @@ struct uiArea {
 
 	// for user window drags
 	GdkEventButton *dragevent;
+
+	// for uiAreaOnFrame()
+	int (*onFrame)(uiArea *, double, double, void *);
+	void *onFrameData;
+	guint frameTick;
 };
 
 G_DEFINE_TYPE(areaWidget, areaWidget, GTK_TYPE_DRAWING_AREA)
@@ -98,6 +103,24 @@ static void areaWidget_size_allocate(GtkWidget *w, GtkAllocation *allocation)
 		gtk_widget_queue_resize(w);
 }
 
+static void stopFrames(uiArea *a)
+{
+	if (a->frameTick != 0)
+		gtk_widget_remove_tick_callback(a->areaWidget, a->frameTick);
+	a->frameTick = 0;
+	a->onFrame = NULL;
+	a->onFrameData = NULL;
+}
+
+// once the area is hidden there's no point in animating it; the application can call uiAreaOnFrame() again when it shows the area
+static void areaWidget_unmap(GtkWidget *w)
+{
+	areaWidget *aw = areaWidget(w);
+
+	stopFrames(aw->a);
+	GTK_WIDGET_CLASS(areaWidget_parent_class)->unmap(w);
+}
+
 static void loadAreaSize(uiArea *a, double *width, double *height)
 {
 	GtkAllocation allocation;
@@ -121,7 +144,14 @@ static gboolean areaWidget_draw(GtkWidget *w, cairo_t *cr)
 	uiArea *a = aw->a;
 	uiAreaDrawParams dp;
 	double clipX0, clipY0, clipX1, clipY1;
-
+	uiprivArenaMark mark;
+	uiprivDispatch d;
+	cairo_rectangle_list_t *list;
+	uiAreaRect *damage;
+	int i, n;
+
+	// everything allocated for this frame comes from the frame arena and goes away once the handler returns
+	mark = uiprivFrameArenaMark();
 	dp.Context = uiprivNewContext(cr,
 		gtk_widget_get_style_context(a->widget));
 
@@ -133,10 +163,38 @@ static gboolean areaWidget_draw(GtkWidget *w, cairo_t *cr)
 	dp.ClipWidth = clipX1 - clipX0;
 	dp.ClipHeight = clipY1 - clipY0;
 
+	// the clip extents are just the bounding box; GTK+ clips to the exact region it's redrawing, so get the rectangles that make it up
+	list = cairo_copy_clip_rectangle_list(cr);
+	if (list->status == CAIRO_STATUS_SUCCESS) {
+		n = list->num_rectangles;
+		damage = (uiAreaRect *) uiprivFrameArenaAlloc(n * sizeof (uiAreaRect));
+		for (i = 0; i < n; i++) {
+			damage[i].X = list->rectangles[i].x;
+			damage[i].Y = list->rectangles[i].y;
+			damage[i].Width = list->rectangles[i].width;
+			damage[i].Height = list->rectangles[i].height;
+		}
+	} else {
+		// the clip can't be described by rectangles (this shouldn't happen with GTK+, but just in case); fall back to the bounding box
+		n = 1;
+		damage = uiprivFrameArenaNew(uiAreaRect);
+		damage->X = dp.ClipX;
+		damage->Y = dp.ClipY;
+		damage->Width = dp.ClipWidth;
+		damage->Height = dp.ClipHeight;
+	}
+	cairo_rectangle_list_destroy(list);
+	dp.DamageRects = damage;
+	dp.NumDamageRects = n;
+	uiprivContextSetDamage(dp.Context, damage, n);
+
 	// no need to save or restore the graphics state to reset transformations; GTK+ does that for us
+	uiprivDispatchBegin(&d, uiLatencyKindDraw, "uiAreaHandler Draw");
 	(*(a->ah->Draw))(a->ah, a, &dp);
+	uiprivDispatchEnd(&d);
 
 	uiprivFreeContext(dp.Context);
+	uiprivFrameArenaRelease(mark);
 	return FALSE;
 }
 
@@ -203,6 +261,8 @@ static uiModifiers toModifiers(guint state)
 // capture on drag is done automatically on GTK+
 static void finishMouseEvent(uiArea *a, uiAreaMouseEvent *me, guint mb, gdouble x, gdouble y, guint state, GdkWindow *window)
 {
+	uiprivDispatch d;
+
 	// on GTK+, mouse buttons 4-7 are for scrolling; if we got here, that's a mistake
 	if (mb >= 4 && mb <= 7)
 		return;
@@ -234,7 +294,9 @@ static void finishMouseEvent(uiArea *a, uiAreaMouseEvent *me, guint mb, gdouble
 
 	loadAreaSize(a, &(me->AreaWidth), &(me->AreaHeight));
 
+	uiprivDispatchBegin(&d, uiLatencyKindControlEvent, "uiAreaHandler MouseEvent");
 	(*(a->ah->MouseEvent))(a->ah, a, me);
+	uiprivDispatchEnd(&d);
 }
 
 static gboolean areaWidget_button_press_event(GtkWidget *w, GdkEventButton *e)
@@ -307,8 +369,11 @@ static gboolean areaWidget_motion_notify_event(GtkWidget *w, GdkEventMotion *e)
 static gboolean onCrossing(areaWidget *aw, int left)
 {
 	uiArea *a = aw->a;
+	uiprivDispatch d;
 
+	uiprivDispatchBegin(&d, uiLatencyKindControlEvent, "uiAreaHandler MouseCrossed");
 	(*(a->ah->MouseCrossed))(a->ah, a, left);
+	uiprivDispatchEnd(&d);
 	uiprivClickCounterReset(a->cc);
 	return GDK_EVENT_PROPAGATE;
 }
@@ -387,6 +452,8 @@ static int areaKeyEvent(uiArea *a, int up, GdkEventKey *e)
 	uiAreaKeyEvent ke;
 	guint state;
 	int i;
+	int handled;
+	uiprivDispatch d;
 
 	ke.Key = 0;
 	ke.ExtKey = 0;
@@ -418,7 +485,10 @@ static int areaKeyEvent(uiArea *a, int up, GdkEventKey *e)
 	return 0;
 
 keyFound:
-	return (*(a->ah->KeyEvent))(a->ah, a, &ke);
+	uiprivDispatchBegin(&d, uiLatencyKindControlEvent, "uiAreaHandler KeyEvent");
+	handled = (*(a->ah->KeyEvent))(a->ah, a, &ke);
+	uiprivDispatchEnd(&d);
+	return handled;
 }
 
 static gboolean areaWidget_key_press_event(GtkWidget *w, GdkEventKey *e)
@@ -474,6 +544,7 @@ static void areaWidget_class_init(areaWidgetClass *class)
 	G_OBJECT_CLASS(class)->get_property = areaWidget_get_property;
 
 	GTK_WIDGET_CLASS(class)->size_allocate = areaWidget_size_allocate;
+	GTK_WIDGET_CLASS(class)->unmap = areaWidget_unmap;
 	GTK_WIDGET_CLASS(class)->draw = areaWidget_draw;
 	GTK_WIDGET_CLASS(class)->get_preferred_height = areaWidget_get_preferred_height;
 	GTK_WIDGET_CLASS(class)->get_preferred_width = areaWidget_get_preferred_width;
@@ -510,6 +581,97 @@ void uiAreaQueueRedrawAll(uiArea *a)
 	gtk_widget_queue_draw(a->areaWidget);
 }
 
+// rounds the rectangle out to whole pixels and clips it to the area widget, which for scrolling areas covers the whole scrollable content; returns FALSE if nothing is left
+// clipping first also keeps huge or infinite coordinates from overflowing the conversion to int
+static gboolean redrawRect(uiArea *a, double x, double y, double width, double height, cairo_rectangle_int_t *r)
+{
+	GtkAllocation allocation;
+	double x0, y0, x1, y1;
+
+	if (!(width > 0 && height > 0))
+		return FALSE;
+	gtk_widget_get_allocation(a->areaWidget, &allocation);
+	x0 = MAX(floor(x), 0);
+	y0 = MAX(floor(y), 0);
+	x1 = MIN(ceil(x + width), allocation.width);
+	y1 = MIN(ceil(y + height), allocation.height);
+	if (x1 <= x0 || y1 <= y0)
+		return FALSE;
+	r->x = (int) x0;
+	r->y = (int) y0;
+	r->width = (int) (x1 - x0);
+	r->height = (int) (y1 - y0);
+	return TRUE;
+}
+
+void uiAreaQueueRedrawRect(uiArea *a, double x, double y, double width, double height)
+{
+	cairo_rectangle_int_t r;
+
+	if (redrawRect(a, x, y, width, height, &r))
+		gtk_widget_queue_draw_area(a->areaWidget, r.x, r.y, r.width, r.height);
+}
+
+void uiAreaQueueRedrawRects(uiArea *a, const uiAreaRect *rects, int n)
+{
+	cairo_region_t *region;
+	cairo_rectangle_int_t r;
+	int i;
+
+	region = cairo_region_create();
+	for (i = 0; i < n; i++)
+		if (redrawRect(a, rects[i].X, rects[i].Y, rects[i].Width, rects[i].Height, &r))
+			cairo_region_union_rectangle(region, &r);
+	if (!cairo_region_is_empty(region))
+		gtk_widget_queue_draw_region(a->areaWidget, region);
+	cairo_region_destroy(region);
+}
+
+// the frame clock runs tick callbacks in its update phase, right before layout and paint, so anything the callback queues is drawn in the same frame
+static gboolean areaFrameTick(GtkWidget *w, GdkFrameClock *clock, gpointer data)
+{
+	uiArea *a = (uiArea *) data;
+	GdkFrameTimings *timings;
+	gint64 frameTime, presentationTime, refreshInterval;
+	guint tick;
+	int more;
+	uiprivDispatch d;
+
+	frameTime = gdk_frame_clock_get_frame_time(clock);
+	// not every backend can predict when the frame will be shown; if it can't, estimate from the refresh rate, and failing that, just use the frame time
+	presentationTime = 0;
+	timings = gdk_frame_clock_get_current_timings(clock);
+	if (timings != NULL)
+		presentationTime = gdk_frame_timings_get_predicted_presentation_time(timings);
+	if (presentationTime == 0)
+		gdk_frame_clock_get_refresh_info(clock, frameTime, &refreshInterval, &presentationTime);
+	if (presentationTime == 0)
+		presentationTime = frameTime;
+	tick = a->frameTick;
+	uiprivDispatchBegin(&d, uiLatencyKindControlEvent, "uiArea OnFrame");
+	more = (*(a->onFrame))(a, (double) frameTime / 1000, (double) presentationTime / 1000, a->onFrameData);
+	uiprivDispatchEnd(&d);
+	if (more)
+		return G_SOURCE_CONTINUE;
+	// if the callback called uiAreaOnFrame() itself, this tick callback is already gone, and the new one must be left alone
+	if (a->frameTick == tick) {
+		// GTK+ removes the tick callback itself when we return G_SOURCE_REMOVE
+		a->frameTick = 0;
+		stopFrames(a);
+	}
+	return G_SOURCE_REMOVE;
+}
+
+void uiAreaOnFrame(uiArea *a, int (*f)(uiArea *a, double frameTime, double presentationTime, void *data), void *data)
+{
+	stopFrames(a);
+	if (f == NULL)
+		return;
+	a->onFrame = f;
+	a->onFrameData = data;
+	a->frameTick = gtk_widget_add_tick_callback(a->areaWidget, areaFrameTick, a, NULL);
+}
+
 void uiAreaScrollTo(uiArea *a, double x, double y, double width, double height)
 {
 	// TODO
@@ -0,0 +1,94 @@
+// 18 october 2026
+#include "uipriv_unix.h"
+
+// the frame arena is a bump allocator for things that only need to live until a draw handler returns
+// chunks are never given back until uiUninit(), so once a few frames have been drawn, drawing doesn't touch the heap at all
+// draws can nest (for instance, if a draw handler runs a nested main loop), so instead of resetting the arena outright, each draw remembers where the arena was when it started and goes back to that point when it's done
+// unlike the rest of the allocator, the frame arena is not thread-safe; draw handlers only ever run on the main thread
+
+#define arenaAlign 16
+#define arenaChunkSize 16384
+
+struct uiprivArenaChunk {
+	uiprivArenaChunk *next;
+	size_t size;
+};
+
+// keep data aligned as well as g_malloc() would
+#define chunkExtra ((sizeof (uiprivArenaChunk) + arenaAlign - 1) / arenaAlign * arenaAlign)
+#define chunkData(c) (((uint8_t *) (c)) + chunkExtra)
+
+static uiprivArenaChunk *first = NULL;
+static uiprivArenaChunk *cur = NULL;
+static size_t used = 0;
+
+void uiprivUninitFrameArena(void)
+{
+	uiprivArenaChunk *c, *next;
+
+	for (c = first; c != NULL; c = next) {
+		next = c->next;
+		g_free(c);
+	}
+	first = NULL;
+	cur = NULL;
+	used = 0;
+}
+
+uiprivArenaMark uiprivFrameArenaMark(void)
+{
+	uiprivArenaMark m;
+
+	m.chunk = cur;
+	m.used = used;
+	return m;
+}
+
+void uiprivFrameArenaRelease(uiprivArenaMark m)
+{
+	// the chunks after m.chunk stay in the list to be reused by the next frame
+	cur = m.chunk;
+	used = m.used;
+}
+
+static uiprivArenaChunk *newChunk(size_t size)
+{
+	uiprivArenaChunk *c;
+
+	if (size < arenaChunkSize - chunkExtra)
+		size = arenaChunkSize - chunkExtra;
+	c = (uiprivArenaChunk *) g_malloc(chunkExtra + size);
+	c->next = NULL;
+	c->size = size;
+	return c;
+}
+
+void *uiprivFrameArenaAlloc(size_t size)
+{
+	uiprivArenaChunk *next;
+	void *out;
+
+	size = (size + arenaAlign - 1) / arenaAlign * arenaAlign;
+	if (cur == NULL || cur->size - used < size) {
+		// move on to the next chunk, if it's big enough; otherwise slot a new one in before it
+		next = first;
+		if (cur != NULL)
+			next = cur->next;
+		if (next == NULL || next->size < size) {
+			next = newChunk(size);
+			if (cur == NULL) {
+				next->next = first;
+				first = next;
+			} else {
+				next->next = cur->next;
+				cur->next = next;
+			}
+		}
+		cur = next;
+		used = 0;
+	}
+	out = chunkData(cur) + used;
+	used += size;
+	memset(out, 0, size);
+	return out;
+}
@@ -14,8 +14,11 @@ uiUnixControlAllDefaults(uiButton)
 static void onClicked(GtkButton *button, gpointer data)
 {
 	uiButton *b = uiButton(data);
+	uiprivDispatch dispatch;
 
+	uiprivDispatchBegin(&dispatch, uiLatencyKindControlEvent, "uiButton OnClicked");
 	(*(b->onClicked))(b, b->onClickedData);
+	uiprivDispatchEnd(&dispatch);
 }
 
 static void defaultOnClicked(uiButton *b, void *data)
@@ -17,8 +17,11 @@ uiUnixControlAllDefaults(uiCheckbox)
 static void onToggled(GtkToggleButton *b, gpointer data)
 {
 	uiCheckbox *c = uiCheckbox(data);
+	uiprivDispatch dispatch;
 
+	uiprivDispatchBegin(&dispatch, uiLatencyKindControlEvent, "uiCheckbox OnToggled");
 	(*(c->onToggled))(c, c->onToggledData);
+	uiprivDispatchEnd(&dispatch);
 }
 
 static void defaultOnToggled(uiCheckbox *c, void *data)
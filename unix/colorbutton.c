@@ -16,8 +16,11 @@ uiUnixControlAllDefaults(uiColorButton)
 static void onColorSet(GtkColorButton *button, gpointer data)
 {
 	uiColorButton *b = uiColorButton(data);
+	uiprivDispatch dispatch;
 
+	uiprivDispatchBegin(&dispatch, uiLatencyKindControlEvent, "uiColorButton OnChanged");
 	(*(b->onChanged))(b, b->onChangedData);
+	uiprivDispatchEnd(&dispatch);
 }
 
 static void defaultOnChanged(uiColorButton *b, void *data)
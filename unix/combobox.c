@@ -16,8 +16,11 @@ uiUnixControlAllDefaults(uiCombobox)
 static void onChanged(GtkComboBox *cbox, gpointer data)
 {
 	uiCombobox *c = uiCombobox(data);
+	uiprivDispatch dispatch;
 
+	uiprivDispatchBegin(&dispatch, uiLatencyKindControlEvent, "uiCombobox OnSelected");
 	(*(c->onSelected))(c, c->onSelectedData);
+	uiprivDispatchEnd(&dispatch);
 }
 
 static void defaultOnSelected(uiCombobox *c, void *data)
@@ -611,9 +611,12 @@ void uiDateTimePickerOnChanged(uiDateTimePicker *d, void (*f)(uiDateTimePicker *
 static void onChanged(uiprivDateTimePickerWidget *d, gpointer data)
 {
 	uiDateTimePicker *c;
+	uiprivDispatch dispatch;
 
 	c = uiDateTimePicker(data);
+	uiprivDispatchBegin(&dispatch, uiLatencyKindControlEvent, "uiDateTimePicker OnChanged");
 	(*(c->onChanged))(c, c->onChangedData);
+	uiprivDispatchEnd(&dispatch);
 }
 
 static GtkWidget *newDTP(void)
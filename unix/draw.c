@@ -6,7 +6,7 @@ uiDrawContext *uiprivNewContext(cairo_t *cr, GtkStyleContext *style)
 {
 	uiDrawContext *c;
 
-	c = uiprivNew(uiDrawContext);
+	c = uiprivFrameArenaNew(uiDrawContext);
 	c->cr = cr;
 	c->style = style;
 	return c;
@@ -14,8 +14,94 @@ uiDrawContext *uiprivNewContext(cairo_t *cr, GtkStyleContext *style)
 
 void uiprivFreeContext(uiDrawContext *c)
 {
+	if (c->saved != NULL)
+		uiprivUserBug("You have not finished a display list or layer you started on uiDrawContext %p.", c);
 	// free neither cr nor style; we own neither
-	uiprivFree(c);
+	// c itself lives in the frame arena, and so does the damage
+}
+
+void uiprivContextPushTarget(uiDrawContext *c, cairo_surface_t *s, int kind)
+{
+	uiprivSavedTarget *t;
+
+	t = uiprivNew(uiprivSavedTarget);
+	t->cr = c->cr;
+	t->kind = kind;
+	t->next = c->saved;
+	c->saved = t;
+	c->cr = cairo_create(s);
+}
+
+// returns a new reference to the surface that was being drawn to
+cairo_surface_t *uiprivContextPopTarget(uiDrawContext *c, int kind, const char *func)
+{
+	uiprivSavedTarget *t;
+	cairo_surface_t *s;
+
+	t = c->saved;
+	if (t == NULL || t->kind != kind)
+		uiprivUserBug("%s() called without a matching begin on uiDrawContext %p.", func, c);
+	s = cairo_surface_reference(cairo_get_target(c->cr));
+	cairo_destroy(c->cr);
+	c->cr = t->cr;
+	c->saved = t->next;
+	uiprivFree(t);
+	return s;
+}
+
+// the damage is kept in device space, so it can be tested against whatever transform is current when uiDrawIntersectsDamage() is called
+static void toDevice(cairo_t *cr, double x, double y, double width, double height, uiprivDamage *d)
+{
+	double xs[4], ys[4];
+	int i;
+
+	xs[0] = x;
+	ys[0] = y;
+	xs[1] = x + width;
+	ys[1] = y;
+	xs[2] = x;
+	ys[2] = y + height;
+	xs[3] = x + width;
+	ys[3] = y + height;
+	// with a rotation or skew the corners can end up in any order, so take the bounding box of all four
+	for (i = 0; i < 4; i++)
+		cairo_user_to_device(cr, &xs[i], &ys[i]);
+	d->x0 = d->x1 = xs[0];
+	d->y0 = d->y1 = ys[0];
+	for (i = 1; i < 4; i++) {
+		d->x0 = MIN(d->x0, xs[i]);
+		d->y0 = MIN(d->y0, ys[i]);
+		d->x1 = MAX(d->x1, xs[i]);
+		d->y1 = MAX(d->y1, ys[i]);
+	}
+}
+
+void uiprivContextSetDamage(uiDrawContext *c, const uiAreaRect *rects, int n)
+{
+	int i;
+
+	c->hasDamage = TRUE;
+	c->damage = (uiprivDamage *) uiprivFrameArenaAlloc(n * sizeof (uiprivDamage));
+	c->nDamage = n;
+	for (i = 0; i < n; i++)
+		toDevice(c->cr, rects[i].X, rects[i].Y, rects[i].Width, rects[i].Height, &(c->damage[i]));
+}
+
+int uiDrawIntersectsDamage(uiDrawContext *c, double x, double y, double width, double height)
+{
+	uiprivDamage r, *d;
+	int i;
+
+	// what's drawn into a display list can be replayed anywhere
+	if (!c->hasDamage || c->saved != NULL)
+		return 1;
+	toDevice(c->cr, x, y, width, height, &r);
+	for (i = 0; i < c->nDamage; i++) {
+		d = &(c->damage[i]);
+		if (r.x0 < d->x1 && d->x0 < r.x1 && r.y0 < d->y1 && d->y0 < r.y1)
+			return 1;
+	}
+	return 0;
 }
 
 static cairo_pattern_t *mkbrush(uiDrawBrush *b)
@@ -55,13 +141,125 @@ static cairo_pattern_t *mkbrush(uiDrawBrush *b)
 	return pat;
 }
 
-void uiDrawStroke(uiDrawContext *c, uiDrawPath *path, uiDrawBrush *b, uiDrawStrokeParams *p)
+// gradients are expensive to build (every stop is added one at a time, and cairo sorts and copies them), and programs tend to fill with the same few over and over, every frame; so we keep the last few we built, along with a copy of the brush each came from, and reuse the pattern if a brush matches one exactly
+// patterns are immutable once built and their reference counts are atomic, so the cache can be shared by every thread that draws, with a lock around the lookup
+#define nCachedGradients 8
+
+struct cachedGradient {
+	uiDrawBrush b;
+	// a copy of b.Stops, which belongs to the program
+	uiDrawBrushGradientStop *stops;
+	cairo_pattern_t *pat;
+};
+
+static GMutex gradientLock;
+static struct cachedGradient gradients[nCachedGradients];
+// the next entry to replace, round-robin
+static int nextGradient = 0;
+
+static gboolean sameGradient(const struct cachedGradient *g, const uiDrawBrush *b)
+{
+	if (g->pat == NULL)
+		return FALSE;
+	if (g->b.Type != b->Type || g->b.NumStops != b->NumStops)
+		return FALSE;
+	if (g->b.X0 != b->X0 || g->b.Y0 != b->Y0 || g->b.X1 != b->X1 || g->b.Y1 != b->Y1)
+		return FALSE;
+	if (b->Type == uiDrawBrushTypeRadialGradient && g->b.OuterRadius != b->OuterRadius)
+		return FALSE;
+	if (b->NumStops == 0)
+		return TRUE;
+	return memcmp(g->stops, b->Stops, b->NumStops * sizeof (uiDrawBrushGradientStop)) == 0;
+}
+
+// returns a new reference
+static cairo_pattern_t *gradient(uiDrawBrush *b)
 {
+	struct cachedGradient *g;
 	cairo_pattern_t *pat;
+	int i;
 
-	uiprivRunPath(path, c->cr);
+	g_mutex_lock(&gradientLock);
+	for (i = 0; i < nCachedGradients; i++)
+		if (sameGradient(&gradients[i], b)) {
+			pat = cairo_pattern_reference(gradients[i].pat);
+			g_mutex_unlock(&gradientLock);
+			return pat;
+		}
+	g_mutex_unlock(&gradientLock);
+
+	// build it without the lock held, so other threads aren't held up by it
 	pat = mkbrush(b);
-	cairo_set_source(c->cr, pat);
+
+	g_mutex_lock(&gradientLock);
+	g = &gradients[nextGradient];
+	nextGradient = (nextGradient + 1) % nCachedGradients;
+	if (g->pat != NULL) {
+		cairo_pattern_destroy(g->pat);
+		g_free(g->stops);
+	}
+	g->b = *b;
+	g->stops = g_new(uiDrawBrushGradientStop, b->NumStops + 1);
+	if (b->NumStops != 0)
+		memcpy(g->stops, b->Stops, b->NumStops * sizeof (uiDrawBrushGradientStop));
+	g->b.Stops = g->stops;
+	g->pat = cairo_pattern_reference(pat);
+	g_mutex_unlock(&gradientLock);
+	return pat;
+}
+
+void uiprivUninitGradientCache(void)
+{
+	int i;
+
+	for (i = 0; i < nCachedGradients; i++)
+		if (gradients[i].pat != NULL) {
+			cairo_pattern_destroy(gradients[i].pat);
+			g_free(gradients[i].stops);
+		}
+	memset(gradients, 0, sizeof (gradients));
+	nextGradient = 0;
+}
+
+// solid colors don't need a pattern of our own: cairo recycles its solid patterns internally, and skips the work entirely if the color didn't change
+static void setSource(cairo_t *cr, uiDrawBrush *b)
+{
+	cairo_pattern_t *pat;
+
+	if (b->Type == uiDrawBrushTypeSolid) {
+		cairo_set_source_rgba(cr, b->R, b->G, b->B, b->A);
+		return;
+	}
+	pat = gradient(b);
+	cairo_set_source(cr, pat);
+	// cairo_set_source() took its own reference
+	cairo_pattern_destroy(pat);
+}
+
+// a uiDrawCachedBrush is just the pattern; a program that holds onto one skips even the cache lookup
+struct uiDrawCachedBrush {
+	cairo_pattern_t *pat;
+};
+
+uiDrawCachedBrush *uiDrawNewCachedBrush(uiDrawBrush *b)
+{
+	uiDrawCachedBrush *cb;
+
+	cb = uiprivNew(uiDrawCachedBrush);
+	// unlike setSource(), solid colors get a pattern too, so using one is the same cairo_set_source() call either way
+	cb->pat = mkbrush(b);
+	return cb;
+}
+
+void uiDrawFreeCachedBrush(uiDrawCachedBrush *cb)
+{
+	cairo_pattern_destroy(cb->pat);
+	uiprivFree(cb);
+}
+
+static void stroke(uiDrawContext *c, uiDrawPath *path, uiDrawStrokeParams *p)
+{
+	uiprivRunPath(path, c->cr);
 	switch (p->Cap) {
 	case uiDrawLineCapFlat:
 		cairo_set_line_cap(c->cr, CAIRO_LINE_CAP_BUTT);
@@ -88,16 +286,23 @@ void uiDrawStroke(uiDrawContext *c, uiDrawPath *path, uiDrawBrush *b, uiDrawStro
 	cairo_set_line_width(c->cr, p->Thickness);
 	cairo_set_dash(c->cr, p->Dashes, p->NumDashes, p->DashPhase);
 	cairo_stroke(c->cr);
-	cairo_pattern_destroy(pat);
 }
 
-void uiDrawFill(uiDrawContext *c, uiDrawPath *path, uiDrawBrush *b)
+void uiDrawStroke(uiDrawContext *c, uiDrawPath *path, uiDrawBrush *b, uiDrawStrokeParams *p)
 {
-	cairo_pattern_t *pat;
+	setSource(c->cr, b);
+	stroke(c, path, p);
+}
 
+void uiDrawCachedBrushStroke(uiDrawContext *c, uiDrawPath *path, uiDrawCachedBrush *cb, uiDrawStrokeParams *p)
+{
+	cairo_set_source(c->cr, cb->pat);
+	stroke(c, path, p);
+}
+
+static void fill(uiDrawContext *c, uiDrawPath *path)
+{
 	uiprivRunPath(path, c->cr);
-	pat = mkbrush(b);
-	cairo_set_source(c->cr, pat);
 	switch (uiprivPathFillMode(path)) {
 	case uiDrawFillModeWinding:
 		cairo_set_fill_rule(c->cr, CAIRO_FILL_RULE_WINDING);
@@ -107,7 +312,18 @@ void uiDrawFill(uiDrawContext *c, uiDrawPath *path, uiDrawBrush *b)
 		break;
 	}
 	cairo_fill(c->cr);
-	cairo_pattern_destroy(pat);
+}
+
+void uiDrawFill(uiDrawContext *c, uiDrawPath *path, uiDrawBrush *b)
+{
+	setSource(c->cr, b);
+	fill(c, path);
+}
+
+void uiDrawCachedBrushFill(uiDrawContext *c, uiDrawPath *path, uiDrawCachedBrush *cb)
+{
+	cairo_set_source(c->cr, cb->pat);
+	fill(c, path);
 }
 
 void uiDrawTransform(uiDrawContext *c, uiDrawMatrix *m)
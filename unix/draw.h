@@ -1,11 +1,41 @@
 // 5 may 2016
 
 // draw.c
+typedef struct uiprivDamage uiprivDamage;
+struct uiprivDamage {
+	double x0;
+	double y0;
+	double x1;
+	double y1;
+};
+
+// while a display list is being recorded or a layer is being drawn, drawing goes to a cairo_t of its own, and the cairo_t it replaced waits here
+typedef struct uiprivSavedTarget uiprivSavedTarget;
+struct uiprivSavedTarget {
+	cairo_t *cr;
+	int kind;
+	uiprivSavedTarget *next;
+};
+
+enum {
+	uiprivTargetDisplayList,
+	uiprivTargetLayer,
+};
+
 struct uiDrawContext {
 	cairo_t *cr;
 	GtkStyleContext *style;
+	// the rectangles being redrawn, in device space; if hasDamage is FALSE, everything is
+	gboolean hasDamage;
+	uiprivDamage *damage;
+	int nDamage;
+	uiprivSavedTarget *saved;
 };
 
+extern void uiprivContextSetDamage(uiDrawContext *c, const uiAreaRect *rects, int n);
+extern void uiprivContextPushTarget(uiDrawContext *c, cairo_surface_t *s, int kind);
+extern cairo_surface_t *uiprivContextPopTarget(uiDrawContext *c, int kind, const char *func);
+
 struct uiDrawBitmap {
 	int Width;
 	int Height;
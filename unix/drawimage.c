@@ -0,0 +1,94 @@
+// 18 october 2026
+#include "uipriv_unix.h"
+#include "draw.h"
+
+// a uiUnixDrawImage is a cairo image surface with a uiDrawContext on it that lives as long as the image does
+// nothing here touches GDK, so it works before uiInit(), and without a display at all; the only other thing drawing needs from GDK is the Pango context for text layouts, and drawtext.c falls back to plain Pango cairo when there is no screen
+// unlike the context a uiArea hands its Draw handler, this one isn't in the frame arena, since it outlives any one frame; it never has damage, so nothing drawn on it is culled
+
+struct uiUnixDrawImage {
+	cairo_surface_t *surface;
+	uiDrawContext *c;
+};
+
+static uiUnixDrawImage *newImage(cairo_surface_t *s, const char *func)
+{
+	uiUnixDrawImage *img;
+
+	if (cairo_surface_status(s) != CAIRO_STATUS_SUCCESS)
+		uiprivUserBug("Error creating the image in %s(): %s", func, cairo_status_to_string(cairo_surface_status(s)));
+	// images can be made before uiInit(), which is what normally loads these
+	uiprivLoadFutures();
+	img = uiprivNew(uiUnixDrawImage);
+	img->surface = s;
+	img->c = uiprivNew(uiDrawContext);
+	img->c->cr = cairo_create(s);
+	img->c->style = NULL;
+	return img;
+}
+
+uiUnixDrawImage *uiUnixNewDrawImage(int width, int height)
+{
+	if (width <= 0 || height <= 0)
+		uiprivUserBug("Invalid size %dx%d passed to uiUnixNewDrawImage().", width, height);
+	// cairo zeroes new image surfaces, so the image starts out fully transparent
+	return newImage(cairo_image_surface_create(CAIRO_FORMAT_ARGB32, width, height), "uiUnixNewDrawImage");
+}
+
+uiUnixDrawImage *uiUnixNewDrawImageForData(uint8_t *data, int width, int height, int stride)
+{
+	if (width <= 0 || height <= 0)
+		uiprivUserBug("Invalid size %dx%d passed to uiUnixNewDrawImageForData().", width, height);
+	if (stride < cairo_format_stride_for_width(CAIRO_FORMAT_ARGB32, width) || stride % 4 != 0)
+		uiprivUserBug("Invalid stride %d passed to uiUnixNewDrawImageForData(); it must be a multiple of 4 at least %d.", stride, cairo_format_stride_for_width(CAIRO_FORMAT_ARGB32, width));
+	return newImage(cairo_image_surface_create_for_data(data, CAIRO_FORMAT_ARGB32, width, height, stride), "uiUnixNewDrawImageForData");
+}
+
+void uiUnixFreeDrawImage(uiUnixDrawImage *img)
+{
+	uiprivFreeContext(img->c);
+	cairo_destroy(img->c->cr);
+	uiprivFree(img->c);
+	cairo_surface_destroy(img->surface);
+	uiprivFree(img);
+}
+
+uiDrawContext *uiUnixDrawImageContext(uiUnixDrawImage *img)
+{
+	return img->c;
+}
+
+int uiUnixDrawImageSetScale(uiUnixDrawImage *img, double scale)
+{
+	if (scale <= 0)
+		uiprivUserBug("Invalid scale %g passed to uiUnixDrawImageSetScale().", scale);
+	if (img->c->saved != NULL)
+		uiprivUserBug("You cannot call uiUnixDrawImageSetScale() while a display list or layer is unfinished on uiUnixDrawImage %p.", img);
+	if (!uiprivFUTURE_cairo_surface_set_device_scale(img->surface, scale, scale))
+		return 0;
+	// a cairo_t only looks at its target's device scale when it's created, so start a new one; this is also what makes the transform and clip start over
+	cairo_destroy(img->c->cr);
+	img->c->cr = cairo_create(img->surface);
+	return 1;
+}
+
+static void finish(uiUnixDrawImage *img, const char *func)
+{
+	if (img->c->saved != NULL)
+		uiprivUserBug("You cannot call %s() while a display list or layer is unfinished on uiUnixDrawImage %p.", func, img);
+	// cairo can batch drawing; make sure all of it has reached the pixels
+	cairo_surface_flush(img->surface);
+}
+
+uint8_t *uiUnixDrawImageData(uiUnixDrawImage *img, int *stride)
+{
+	finish(img, "uiUnixDrawImageData");
+	*stride = cairo_image_surface_get_stride(img->surface);
+	return cairo_image_surface_get_data(img->surface);
+}
+
+int uiUnixDrawImageWritePNG(uiUnixDrawImage *img, const char *filename)
+{
+	finish(img, "uiUnixDrawImageWritePNG");
+	return cairo_surface_write_to_png(img->surface, filename) == CAIRO_STATUS_SUCCESS;
+}
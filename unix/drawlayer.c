@@ -0,0 +1,177 @@
+// 18 october 2026
+#include "uipriv_unix.h"
+#include "draw.h"
+
+// a layer is a set of offscreen surfaces made with cairo_surface_create_similar(), so they're in whatever format is fastest to composite onto the real target (often an X server pixmap or a GPU-backed surface), and compositing one is a single blit instead of a rasterization of everything that was drawn into it
+// since cairo 1.14, a similar surface takes on the device scale of the surface it was made from, so a layer made on a HiDPI monitor has one pixel per device pixel; the contents at one scale would be blurry at another, so each layer keeps a small cache of surfaces keyed by device scale, for windows that move between monitors
+// the cache is tiny and evicted least recently drawn first; a program with many layers on many monitors at once is not a case worth more than that
+
+#define nCached 3
+
+struct layerSurface {
+	double scale;
+	cairo_surface_t *s;
+	gboolean valid;
+	// when the contents were last drawn, in the layer's own clock, for eviction
+	guint64 used;
+};
+
+struct uiDrawLayer {
+	double width;
+	double height;
+	struct layerSurface cache[nCached];
+	guint64 clock;
+	// the entry being drawn between uiDrawLayerBegin() and uiDrawLayerEnd(), or NULL
+	struct layerSurface *drawing;
+};
+
+static double contextScale(uiDrawContext *c)
+{
+	double x, y;
+
+	if (!uiprivFUTURE_cairo_surface_get_device_scale(cairo_get_target(c->cr), &x, &y))
+		return 1;
+	// GTK+ always scales both axes the same
+	return x;
+}
+
+static struct layerSurface *findSurface(uiDrawLayer *l, double scale)
+{
+	int i;
+
+	for (i = 0; i < nCached; i++)
+		if (l->cache[i].s != NULL && l->cache[i].scale == scale)
+			return &(l->cache[i]);
+	return NULL;
+}
+
+uiDrawLayer *uiDrawNewLayer(double width, double height)
+{
+	uiDrawLayer *l;
+
+	if (width <= 0 || height <= 0)
+		uiprivUserBug("Invalid size %gx%g passed to uiDrawNewLayer().", width, height);
+	l = uiprivNew(uiDrawLayer);
+	l->width = width;
+	l->height = height;
+	return l;
+}
+
+void uiDrawFreeLayer(uiDrawLayer *l)
+{
+	int i;
+
+	if (l->drawing != NULL)
+		uiprivUserBug("You cannot free uiDrawLayer %p while it is being drawn.", l);
+	for (i = 0; i < nCached; i++)
+		if (l->cache[i].s != NULL)
+			cairo_surface_destroy(l->cache[i].s);
+	uiprivFree(l);
+}
+
+int uiDrawLayerValid(uiDrawContext *c, uiDrawLayer *l)
+{
+	struct layerSurface *ls;
+
+	ls = findSurface(l, contextScale(c));
+	return ls != NULL && ls->valid;
+}
+
+void uiDrawLayerInvalidate(uiDrawLayer *l)
+{
+	int i;
+
+	// keep the surfaces themselves, so redrawing doesn't have to allocate
+	for (i = 0; i < nCached; i++)
+		l->cache[i].valid = FALSE;
+}
+
+void uiDrawLayerBegin(uiDrawContext *c, uiDrawLayer *l)
+{
+	struct layerSurface *ls;
+	double scale;
+	int i;
+
+	if (l->drawing != NULL)
+		uiprivUserBug("You cannot begin drawing uiDrawLayer %p while it is already being drawn.", l);
+	scale = contextScale(c);
+	ls = findSurface(l, scale);
+	if (ls == NULL) {
+		// take an empty entry, or else the least recently drawn one
+		ls = &(l->cache[0]);
+		for (i = 0; i < nCached; i++) {
+			if (l->cache[i].s == NULL) {
+				ls = &(l->cache[i]);
+				break;
+			}
+			if (l->cache[i].used < ls->used)
+				ls = &(l->cache[i]);
+		}
+		if (ls->s != NULL)
+			cairo_surface_destroy(ls->s);
+		// the size is in units of the target's device scale, so this is width * scale pixels across
+		ls->s = cairo_surface_create_similar(cairo_get_target(c->cr),
+			CAIRO_CONTENT_COLOR_ALPHA,
+			(int) ceil(l->width), (int) ceil(l->height));
+		ls->scale = scale;
+	}
+	ls->valid = FALSE;
+	l->drawing = ls;
+	uiprivContextPushTarget(c, ls->s, uiprivTargetLayer);
+	// a reused surface still has its old contents
+	cairo_set_operator(c->cr, CAIRO_OPERATOR_CLEAR);
+	cairo_paint(c->cr);
+	cairo_set_operator(c->cr, CAIRO_OPERATOR_OVER);
+}
+
+void uiDrawLayerEnd(uiDrawContext *c, uiDrawLayer *l)
+{
+	cairo_surface_t *s;
+
+	if (l->drawing == NULL)
+		uiprivUserBug("uiDrawLayerEnd() called on uiDrawLayer %p, which is not being drawn.", l);
+	s = uiprivContextPopTarget(c, uiprivTargetLayer, "uiDrawLayerEnd");
+	// the cache already holds a reference
+	cairo_surface_flush(s);
+	cairo_surface_destroy(s);
+	l->drawing->valid = TRUE;
+	l->drawing->used = ++(l->clock);
+	l->drawing = NULL;
+}
+
+void uiDrawLayerDraw(uiDrawContext *c, uiDrawLayer *l, uiDrawMatrix *m, double opacity)
+{
+	struct layerSurface *ls;
+	cairo_matrix_t cm;
+	int i;
+
+	if (l->drawing != NULL)
+		uiprivUserBug("You cannot draw uiDrawLayer %p into a context while it is being drawn.", l);
+	if (opacity <= 0)
+		return;
+	ls = findSurface(l, contextScale(c));
+	if (ls == NULL || !ls->valid) {
+		// contents drawn at another scale are better than nothing; cairo resamples them
+		ls = NULL;
+		for (i = 0; i < nCached; i++)
+			if (l->cache[i].s != NULL && l->cache[i].valid) {
+				ls = &(l->cache[i]);
+				break;
+			}
+		if (ls == NULL)
+			return;
+	}
+	cairo_save(c->cr);
+	if (m != NULL) {
+		uiprivM2C(m, &cm);
+		cairo_transform(c->cr, &cm);
+	}
+	if (uiDrawIntersectsDamage(c, 0, 0, l->width, l->height)) {
+		cairo_set_source_surface(c->cr, ls->s, 0, 0);
+		if (opacity >= 1)
+			cairo_paint(c->cr);
+		else
+			cairo_paint_with_alpha(c->cr, opacity);
+	}
+	cairo_restore(c->cr);
+}
@@ -0,0 +1,59 @@
+// 18 october 2026
+#include "uipriv_unix.h"
+#include "draw.h"
+
+// a display list is a cairo recording surface: while one is being recorded, the uiDrawContext draws to the recording surface instead of its real target, and cairo keeps every operation, with its paths, sources and glyphs, in a form it can replay quickly
+// the recording surface is unbounded, so nothing recorded is cut off, and it's replayed as vectors, so a list drawn under a scale still comes out sharp
+
+struct uiUnixDrawDisplayList {
+	cairo_surface_t *surface;
+	// the bounding box of everything recorded, so replaying can be skipped when none of it would be seen
+	double x;
+	double y;
+	double width;
+	double height;
+};
+
+void uiUnixDrawBeginDisplayList(uiDrawContext *c)
+{
+	cairo_surface_t *s;
+
+	s = cairo_recording_surface_create(CAIRO_CONTENT_COLOR_ALPHA, NULL);
+	uiprivContextPushTarget(c, s, uiprivTargetDisplayList);
+	// the context holds the only reference we need
+	cairo_surface_destroy(s);
+}
+
+uiUnixDrawDisplayList *uiUnixDrawEndDisplayList(uiDrawContext *c)
+{
+	uiUnixDrawDisplayList *dl;
+
+	dl = uiprivNew(uiUnixDrawDisplayList);
+	dl->surface = uiprivContextPopTarget(c, uiprivTargetDisplayList, "uiUnixDrawEndDisplayList");
+	cairo_recording_surface_ink_extents(dl->surface, &(dl->x), &(dl->y), &(dl->width), &(dl->height));
+	return dl;
+}
+
+void uiUnixFreeDrawDisplayList(uiUnixDrawDisplayList *dl)
+{
+	cairo_surface_destroy(dl->surface);
+	uiprivFree(dl);
+}
+
+void uiUnixDrawDisplayListDraw(uiDrawContext *c, uiUnixDrawDisplayList *dl, uiDrawMatrix *m)
+{
+	cairo_matrix_t cm;
+
+	if (dl->width <= 0 || dl->height <= 0)
+		return;
+	cairo_save(c->cr);
+	if (m != NULL) {
+		uiprivM2C(m, &cm);
+		cairo_transform(c->cr, &cm);
+	}
+	if (uiDrawIntersectsDamage(c, dl->x, dl->y, dl->width, dl->height)) {
+		cairo_set_source_surface(c->cr, dl->surface, 0, 0);
+		cairo_paint(c->cr);
+	}
+	cairo_restore(c->cr);
+}
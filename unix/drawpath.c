@@ -2,135 +2,279 @@
 #include "uipriv_unix.h"
 #include "draw.h"
 
+// a path is built straight into the form cairo takes it in: a flat array of cairo_path_data_t, where each segment is a header followed by its points, so a line is 32 bytes and drawing hands the whole array to cairo_append_path() instead of making one cairo call per segment
+// the points are kept as doubles and in user space, just as the program gave them; we don't run the path on a scratch cairo_t and cairo_copy_path() it, because cairo stores paths in device space as 24.8 fixed point, so a path copied back out would be rounded to 1/256 of a unit and cut off at about 8 million units, both of which the program's own transform could make visible
+// arcs are the exception; cairo turns an arc into curves with as many segments as the transform in effect calls for, so flattening them ahead of time would make them faceted when scaled up; they stay as arcs, stored inline (see arcData below), and drawing appends the runs between them
+// uiDrawPathReset() empties a path but keeps its memory, so a path rebuilt every frame stops allocating once it has reached its largest size
 struct uiDrawPath {
-	GArray *pieces;
+	cairo_path_data_t *data;
+	size_t nData;
+	size_t cap;
+	// the indices into data of the arcs, in order; NULL until the first arc
+	GArray *arcs;
 	uiDrawFillMode fillMode;
 	gboolean ended;
 };
 
-struct piece {
-	int type;
-	double d[8];
-	int b;
-};
-
-enum {
-	newFigure,
-	newFigureArc,
-	lineTo,
-	arcTo,
-	bezierTo,
-	closeFigure,
-	addRect,
-};
+// an arc is a header with this type, followed by three points: the center, then (radius, start angle), then (end angle, flags)
+// cairo_append_path() never sees one; uiprivRunPath() draws them itself
+#define arcData ((cairo_path_data_type_t) 0x100)
+#define arcNegative 1
+#define arcNewFigure 2
 
 uiDrawPath *uiDrawNewPath(uiDrawFillMode mode)
 {
 	uiDrawPath *p;
 
 	p = uiprivNew(uiDrawPath);
-	p->pieces = g_array_new(FALSE, TRUE, sizeof (struct piece));
 	p->fillMode = mode;
 	return p;
 }
 
 void uiDrawFreePath(uiDrawPath *p)
 {
-	g_array_free(p->pieces, TRUE);
+	if (p->data != NULL)
+		uiprivFree(p->data);
+	if (p->arcs != NULL)
+		g_array_free(p->arcs, TRUE);
 	uiprivFree(p);
 }
 
-static void add(uiDrawPath *p, struct piece *piece)
+void uiDrawPathReset(uiDrawPath *p)
+{
+	p->nData = 0;
+	if (p->arcs != NULL)
+		g_array_set_size(p->arcs, 0);
+	p->ended = FALSE;
+}
+
+// the most a path can hold: cairo_append_path() takes the count as an int, and the size in bytes has to fit in a size_t
+#define maxData ((size_t) MIN(G_MAXINT, G_MAXSIZE / sizeof (cairo_path_data_t)))
+
+static void grow(uiDrawPath *p, size_t n)
 {
+	size_t cap;
+
+	if (n > maxData - p->nData)
+		uiprivUserBug("uiDrawPath %p cannot grow by another %" G_GSIZE_FORMAT " elements; it is too large.", p, n);
+	if (p->nData + n <= p->cap)
+		return;
+	cap = p->cap * 2;
+	if (cap > maxData)
+		cap = maxData;
+	if (cap < p->nData + n)
+		cap = p->nData + n;
+	if (cap < 32)
+		cap = 32;
+	p->data = (cairo_path_data_t *) uiprivRealloc(p->data, cap * sizeof (cairo_path_data_t), "cairo_path_data_t[]");
+	p->cap = cap;
+}
+
+// returns how many elements n things of per elements each take, without overflowing
+static size_t sizeFor(int n, size_t per, const char *func)
+{
+	if ((size_t) n > maxData / per)
+		uiprivUserBug("Count %d passed to %s() is too large.", n, func);
+	return ((size_t) n) * per;
+}
+
+void uiDrawPathReserve(uiDrawPath *p, int n)
+{
+	if (n <= 0)
+		return;
+	// a header and a point each
+	grow(p, sizeFor(n, 2, "uiDrawPathReserve"));
+}
+
+// returns the header; the points follow it
+static cairo_path_data_t *add(uiDrawPath *p, cairo_path_data_type_t type, int nPoints)
+{
+	cairo_path_data_t *d;
+
 	if (p->ended)
 		uiprivUserBug("You cannot modify a uiDrawPath that has been ended. (path: %p)", p);
-	g_array_append_vals(p->pieces, piece, 1);
+	grow(p, nPoints + 1);
+	d = p->data + p->nData;
+	p->nData += nPoints + 1;
+	d->header.type = type;
+	d->header.length = nPoints + 1;
+	return d;
 }
 
 void uiDrawPathNewFigure(uiDrawPath *p, double x, double y)
 {
-	struct piece piece;
+	cairo_path_data_t *d;
 
-	piece.type = newFigure;
-	piece.d[0] = x;
-	piece.d[1] = y;
-	add(p, &piece);
+	d = add(p, CAIRO_PATH_MOVE_TO, 1);
+	d[1].point.x = x;
+	d[1].point.y = y;
 }
 
-void uiDrawPathNewFigureWithArc(uiDrawPath *p, double xCenter, double yCenter, double radius, double startAngle, double sweep, int negative)
+static void addArc(uiDrawPath *p, double xCenter, double yCenter, double radius, double startAngle, double sweep, int flags)
 {
-	struct piece piece;
+	cairo_path_data_t *d;
+	guint at;
 
 	if (sweep > 2 * uiPi)
 		sweep = 2 * uiPi;
-	piece.type = newFigureArc;
-	piece.d[0] = xCenter;
-	piece.d[1] = yCenter;
-	piece.d[2] = radius;
-	piece.d[3] = startAngle;
-	piece.d[4] = sweep;
-	piece.b = negative;
-	add(p, &piece);
+	d = add(p, arcData, 3);
+	d[1].point.x = xCenter;
+	d[1].point.y = yCenter;
+	d[2].point.x = radius;
+	d[2].point.y = startAngle;
+	d[3].point.x = startAngle + sweep;
+	d[3].point.y = (double) flags;
+	if (p->arcs == NULL)
+		p->arcs = g_array_new(FALSE, FALSE, sizeof (guint));
+	at = (guint) (d - p->data);
+	g_array_append_val(p->arcs, at);
+}
+
+void uiDrawPathNewFigureWithArc(uiDrawPath *p, double xCenter, double yCenter, double radius, double startAngle, double sweep, int negative)
+{
+	addArc(p, xCenter, yCenter, radius, startAngle, sweep,
+		arcNewFigure | (negative ? arcNegative : 0));
 }
 
 void uiDrawPathLineTo(uiDrawPath *p, double x, double y)
 {
-	struct piece piece;
+	cairo_path_data_t *d;
 
-	piece.type = lineTo;
-	piece.d[0] = x;
-	piece.d[1] = y;
-	add(p, &piece);
+	d = add(p, CAIRO_PATH_LINE_TO, 1);
+	d[1].point.x = x;
+	d[1].point.y = y;
 }
 
 void uiDrawPathArcTo(uiDrawPath *p, double xCenter, double yCenter, double radius, double startAngle, double sweep, int negative)
 {
-	struct piece piece;
-
-	if (sweep > 2 * uiPi)
-		sweep = 2 * uiPi;
-	piece.type = arcTo;
-	piece.d[0] = xCenter;
-	piece.d[1] = yCenter;
-	piece.d[2] = radius;
-	piece.d[3] = startAngle;
-	piece.d[4] = sweep;
-	piece.b = negative;
-	add(p, &piece);
+	addArc(p, xCenter, yCenter, radius, startAngle, sweep,
+		negative ? arcNegative : 0);
 }
 
 void uiDrawPathBezierTo(uiDrawPath *p, double c1x, double c1y, double c2x, double c2y, double endX, double endY)
 {
-	struct piece piece;
+	cairo_path_data_t *d;
 
-	piece.type = bezierTo;
-	piece.d[0] = c1x;
-	piece.d[1] = c1y;
-	piece.d[2] = c2x;
-	piece.d[3] = c2y;
-	piece.d[4] = endX;
-	piece.d[5] = endY;
-	add(p, &piece);
+	d = add(p, CAIRO_PATH_CURVE_TO, 3);
+	d[1].point.x = c1x;
+	d[1].point.y = c1y;
+	d[2].point.x = c2x;
+	d[2].point.y = c2y;
+	d[3].point.x = endX;
+	d[3].point.y = endY;
 }
 
 void uiDrawPathCloseFigure(uiDrawPath *p)
 {
-	struct piece piece;
-
-	piece.type = closeFigure;
-	add(p, &piece);
+	add(p, CAIRO_PATH_CLOSE_PATH, 0);
 }
 
 void uiDrawPathAddRectangle(uiDrawPath *p, double x, double y, double width, double height)
 {
-	struct piece piece;
+	// this is what cairo_rectangle() does
+	uiDrawPathNewFigure(p, x, y);
+	uiDrawPathLineTo(p, x + width, y);
+	uiDrawPathLineTo(p, x + width, y + height);
+	uiDrawPathLineTo(p, x, y + height);
+	uiDrawPathCloseFigure(p);
+}
+
+// the bulk functions make room once and then write the segments straight into the array, so a point costs a couple of stores instead of a function call and a bounds check
+
+static void checkCount(int n, const char *func)
+{
+	if (n < 0)
+		uiprivUserBug("Invalid count %d passed to %s().", n, func);
+}
+
+static void addLines(uiDrawPath *p, const double *xy, int n, const char *func)
+{
+	cairo_path_data_t *d;
+	size_t size;
+	int i;
 
-	piece.type = addRect;
-	piece.d[0] = x;
-	piece.d[1] = y;
-	piece.d[2] = width;
-	piece.d[3] = height;
-	add(p, &piece);
+	if (n == 0)
+		return;
+	size = sizeFor(n - 1, 2, func);
+	uiDrawPathNewFigure(p, xy[0], xy[1]);
+	grow(p, size);
+	d = p->data + p->nData;
+	for (i = 1; i < n; i++) {
+		d[0].header.type = CAIRO_PATH_LINE_TO;
+		d[0].header.length = 2;
+		d[1].point.x = xy[2 * i];
+		d[1].point.y = xy[2 * i + 1];
+		d += 2;
+	}
+	p->nData += size;
+}
+
+void uiDrawPathAddPolyline(uiDrawPath *p, const double *xy, int n)
+{
+	checkCount(n, "uiDrawPathAddPolyline");
+	addLines(p, xy, n, "uiDrawPathAddPolyline");
+}
+
+void uiDrawPathAddPolygon(uiDrawPath *p, const double *xy, int n)
+{
+	checkCount(n, "uiDrawPathAddPolygon");
+	if (n == 0)
+		return;
+	addLines(p, xy, n, "uiDrawPathAddPolygon");
+	uiDrawPathCloseFigure(p);
+}
+
+void uiDrawPathAddRectangles(uiDrawPath *p, const double *xywh, int n)
+{
+	cairo_path_data_t *d;
+	const double *r;
+	size_t size;
+	int i;
+
+	checkCount(n, "uiDrawPathAddRectangles");
+	if (p->ended)
+		uiprivUserBug("You cannot modify a uiDrawPath that has been ended. (path: %p)", p);
+	// each is a move, three lines, and a close, as in uiDrawPathAddRectangle()
+	size = sizeFor(n, 9, "uiDrawPathAddRectangles");
+	grow(p, size);
+	d = p->data + p->nData;
+	for (i = 0; i < n; i++) {
+		r = xywh + 4 * i;
+		d[0].header.type = CAIRO_PATH_MOVE_TO;
+		d[0].header.length = 2;
+		d[1].point.x = r[0];
+		d[1].point.y = r[1];
+		d[2].header.type = CAIRO_PATH_LINE_TO;
+		d[2].header.length = 2;
+		d[3].point.x = r[0] + r[2];
+		d[3].point.y = r[1];
+		d[4].header.type = CAIRO_PATH_LINE_TO;
+		d[4].header.length = 2;
+		d[5].point.x = r[0] + r[2];
+		d[5].point.y = r[1] + r[3];
+		d[6].header.type = CAIRO_PATH_LINE_TO;
+		d[6].header.length = 2;
+		d[7].point.x = r[0];
+		d[7].point.y = r[1] + r[3];
+		d[8].header.type = CAIRO_PATH_CLOSE_PATH;
+		d[8].header.length = 1;
+		d += 9;
+	}
+	p->nData += size;
+}
+
+void uiDrawPathAddCircles(uiDrawPath *p, const double *xyr, int n)
+{
+	int i;
+
+	checkCount(n, "uiDrawPathAddCircles");
+	// circles are arcs, which cairo has to flatten itself at draw time, so there's less to gain here; just make room for them all at once
+	// each is an arc (a header and three points) and a close
+	grow(p, sizeFor(n, 5, "uiDrawPathAddCircles"));
+	for (i = 0; i < n; i++) {
+		addArc(p, xyr[3 * i], xyr[3 * i + 1], xyr[3 * i + 2], 0, 2 * uiPi, arcNewFigure);
+		uiDrawPathCloseFigure(p);
+	}
 }
 
 void uiDrawPathEnd(uiDrawPath *p)
@@ -143,59 +287,49 @@ int uiDrawPathEnded(uiDrawPath *p)
 	return p->ended == TRUE ? 1 : 0;
 }
 
+static void appendRun(cairo_t *cr, uiDrawPath *p, size_t start, size_t end)
+{
+	cairo_path_t run;
+
+	if (start == end)
+		return;
+	run.status = CAIRO_STATUS_SUCCESS;
+	run.data = p->data + start;
+	// grow() keeps this within an int
+	run.num_data = (int) (end - start);
+	cairo_append_path(cr, &run);
+}
+
 void uiprivRunPath(uiDrawPath *p, cairo_t *cr)
 {
 	guint i;
-	struct piece *piece;
-	void (*arc)(cairo_t *, double, double, double, double, double);
+	size_t start, at;
+	cairo_path_data_t *arc;
+	void (*f)(cairo_t *, double, double, double, double, double);
 
 	if (!p->ended)
 		uiprivUserBug("You cannot draw with a uiDrawPath that has not been ended. (path: %p)", p);
 	cairo_new_path(cr);
-	for (i = 0; i < p->pieces->len; i++) {
-		piece = &g_array_index(p->pieces, struct piece, i);
-		switch (piece->type) {
-		case newFigure:
-			cairo_move_to(cr, piece->d[0], piece->d[1]);
-			break;
-		case newFigureArc:
-			cairo_new_sub_path(cr);
-			// fall through
-		case arcTo:
-			arc = cairo_arc;
-			if (piece->b)
-				arc = cairo_arc_negative;
-			(*arc)(cr,
-				piece->d[0],
-				piece->d[1],
-				piece->d[2],
-				piece->d[3],
-				piece->d[3] + piece->d[4]);
-			break;
-		case lineTo:
-			cairo_line_to(cr, piece->d[0], piece->d[1]);
-			break;
-		case bezierTo:
-			cairo_curve_to(cr,
-				piece->d[0],
-				piece->d[1],
-				piece->d[2],
-				piece->d[3],
-				piece->d[4],
-				piece->d[5]);
-			break;
-		case closeFigure:
-			cairo_close_path(cr);
-			break;
-		case addRect:
-			cairo_rectangle(cr,
-				piece->d[0],
-				piece->d[1],
-				piece->d[2],
-				piece->d[3]);
-			break;
+	start = 0;
+	if (p->arcs != NULL)
+		for (i = 0; i < p->arcs->len; i++) {
+			at = g_array_index(p->arcs, guint, i);
+			appendRun(cr, p, start, at);
+			arc = p->data + at;
+			if (((int) (arc[3].point.y) & arcNewFigure) != 0)
+				cairo_new_sub_path(cr);
+			f = cairo_arc;
+			if (((int) (arc[3].point.y) & arcNegative) != 0)
+				f = cairo_arc_negative;
+			(*f)(cr,
+				arc[1].point.x,
+				arc[1].point.y,
+				arc[2].point.x,
+				arc[2].point.y,
+				arc[3].point.x);
+			start = at + arc[0].header.length;
 		}
-	}
+	appendRun(cr, p, start, p->nData);
 }
 
 uiDrawFillMode uiprivPathFillMode(uiDrawPath *path)
@@ -11,7 +11,13 @@ struct uiDrawTextLayout {
 // the documentation suggests creating cairo_t-specific, GdkScreen-specific, or even GtkWidget-specific contexts, but we can't really do that because we want our uiDrawTextFonts and uiDrawTextLayouts to be context-independent
 // we could use pango_font_map_create_context(pango_cairo_font_map_get_default()) but that will ignore GDK-specific settings
 // so let's use gdk_pango_context_get() instead; even though it's for the default screen only, it's good enough for us
-#define mkGenericPangoCairoContext() (gdk_pango_context_get())
+// without a display there is no default screen (and gdk_pango_context_get() would fail), but text can still be drawn on a uiUnixDrawImage, so fall back to the plain Pango cairo font map there
+static PangoContext *mkGenericPangoCairoContext(void)
+{
+	if (gdk_screen_get_default() == NULL)
+		return pango_font_map_create_context(pango_cairo_font_map_get_default());
+	return gdk_pango_context_get();
+}
 
 static const PangoAlignment pangoAligns[] = {
 	[uiDrawTextAlignLeft] = PANGO_ALIGN_LEFT,
@@ -17,8 +17,11 @@ uiUnixControlAllDefaults(uiEditableCombobox)
 static void onChanged(GtkComboBox *cbox, gpointer data)
 {
 	uiEditableCombobox *c = uiEditableCombobox(data);
+	uiprivDispatch dispatch;
 
+	uiprivDispatchBegin(&dispatch, uiLatencyKindControlEvent, "uiEditableCombobox OnChanged");
 	(*(c->onChanged))(c, c->onChangedData);
+	uiprivDispatchEnd(&dispatch);
 }
 
 static void defaultOnChanged(uiEditableCombobox *c, void *data)
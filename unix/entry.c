@@ -16,8 +16,11 @@ uiUnixControlAllDefaults(uiEntry)
 static void onChanged(GtkEditable *editable, gpointer data)
 {
 	uiEntry *e = uiEntry(data);
+	uiprivDispatch dispatch;
 
+	uiprivDispatchBegin(&dispatch, uiLatencyKindControlEvent, "uiEntry OnChanged");
 	(*(e->onChanged))(e, e->onChangedData);
+	uiprivDispatchEnd(&dispatch);
 }
 
 static void defaultOnChanged(uiEntry *e, void *data)
@@ -0,0 +1,87 @@
+// 18 october 2026
+#include "uipriv_unix.h"
+
+// each watch is its own GSource, with the file descriptor added to it, so the main loop polls it along with everything else and runs the callback without a thread hop or an allocation per event
+// the uiUnixFDWatch is the GSource itself; the main context holds the only reference, so destroying the source frees it
+
+struct uiUnixFDWatch {
+	GSource source;
+	gpointer tag;
+	int fd;
+	int (*f)(uiUnixFDWatch *, int, int, void *);
+	void *data;
+};
+
+static GIOCondition toGIO(int conditions)
+{
+	GIOCondition c;
+
+	// errors and hangups are always reported, whether they were asked for or not, so that a watch doesn't spin on a dead descriptor
+	c = G_IO_ERR | G_IO_HUP | G_IO_NVAL;
+	if ((conditions & uiUnixFDReadable) != 0)
+		c |= G_IO_IN | G_IO_PRI;
+	if ((conditions & uiUnixFDWritable) != 0)
+		c |= G_IO_OUT;
+	return c;
+}
+
+static int fromGIO(GIOCondition c)
+{
+	int conditions;
+
+	conditions = 0;
+	if ((c & (G_IO_IN | G_IO_PRI)) != 0)
+		conditions |= uiUnixFDReadable;
+	if ((c & G_IO_OUT) != 0)
+		conditions |= uiUnixFDWritable;
+	if ((c & (G_IO_ERR | G_IO_HUP | G_IO_NVAL)) != 0)
+		conditions |= uiUnixFDError;
+	return conditions;
+}
+
+static gboolean fdWatchDispatch(GSource *s, GSourceFunc callback, gpointer data)
+{
+	uiUnixFDWatch *w = (uiUnixFDWatch *) s;
+	uiprivDispatch d;
+	int keep;
+
+	uiprivDispatchBegin(&d, uiLatencyKindFDWatch, "uiUnixWatchFD() callback");
+	keep = (*(w->f))(w, w->fd, fromGIO(g_source_query_unix_fd(s, w->tag)), w->data);
+	uiprivDispatchEnd(&d);
+	if (keep)
+		return G_SOURCE_CONTINUE;
+	return G_SOURCE_REMOVE;
+}
+
+static GSourceFuncs fdWatchFuncs = {
+	.dispatch = fdWatchDispatch,
+};
+
+uiUnixFDWatch *uiUnixWatchFD(int fd, int conditions, int (*f)(uiUnixFDWatch *w, int fd, int conditions, void *data), void *data)
+{
+	uiUnixFDWatch *w;
+
+	if (fd < 0)
+		uiprivUserBug("Invalid file descriptor %d passed to uiUnixWatchFD().", fd);
+	w = (uiUnixFDWatch *) g_source_new(&fdWatchFuncs, sizeof (uiUnixFDWatch));
+	g_source_set_name(&(w->source), "libui uiUnixWatchFD()");
+	// the same priority as g_unix_fd_add() and GDK's input events, so data and input take turns, both ahead of redraws
+	g_source_set_priority(&(w->source), G_PRIORITY_DEFAULT);
+	w->fd = fd;
+	w->f = f;
+	w->data = data;
+	w->tag = g_source_add_unix_fd(&(w->source), fd, toGIO(conditions));
+	g_source_attach(&(w->source), NULL);
+	g_source_unref(&(w->source));
+	return w;
+}
+
+void uiUnixFDWatchSetConditions(uiUnixFDWatch *w, int conditions)
+{
+	g_source_modify_unix_fd(&(w->source), w->tag, toGIO(conditions));
+}
+
+void uiUnixFDWatchRemove(uiUnixFDWatch *w)
+{
+	g_source_destroy(&(w->source));
+}
@@ -18,8 +18,11 @@ uiUnixControlAllDefaults(uiFontButton)
 static void onFontSet(GtkFontButton *button, gpointer data)
 {
 	uiFontButton *b = uiFontButton(data);
+	uiprivDispatch dispatch;
 
+	uiprivDispatchBegin(&dispatch, uiLatencyKindControlEvent, "uiFontButton OnChanged");
 	(*(b->onChanged))(b, b->onChangedData);
+	uiprivDispatchEnd(&dispatch);
 }
 
 static void defaultOnChanged(uiFontButton *b, void *data)
@@ -13,21 +13,35 @@ static PangoAttribute *(*newBGAlphaAttr)(guint16 alpha) = NULL;
 // added in GTK+ 3.20; we need 3.10
 static void (*gwpIterSetObjectName)(GtkWidgetPath *path, gint pos, const char *name) = NULL;
 
+// added in cairo 1.14; GTK+ 3.10 only needs 1.12
+static void (*surfaceGetDeviceScale)(cairo_surface_t *surface, double *xScale, double *yScale) = NULL;
+static void (*surfaceSetDeviceScale)(cairo_surface_t *surface, double xScale, double yScale) = NULL;
+
+static gsize loaded = 0;
+
 // note that we treat any error as "the symbols aren't there" (and don't care if dlclose() failed)
+// this runs once, from uiInit() or from whatever needs the futures first; a uiUnixDrawImage can be made before uiInit(), or without it, and on any thread
 void uiprivLoadFutures(void)
 {
 	void *handle;
 
+	if (!g_once_init_enter(&loaded))
+		return;
 	// dlsym() walks the dependency chain, so opening the current process should be sufficient
 	handle = dlopen(NULL, RTLD_LAZY);
-	if (handle == NULL)
+	if (handle == NULL) {
+		g_once_init_leave(&loaded, 1);
 		return;
+	}
 #define GET(var, fn) *((void **) (&var)) = dlsym(handle, #fn)
 	GET(newFeaturesAttr, pango_attr_font_features_new);
 	GET(newFGAlphaAttr, pango_attr_foreground_alpha_new);
 	GET(newBGAlphaAttr, pango_attr_background_alpha_new);
 	GET(gwpIterSetObjectName, gtk_widget_path_iter_set_object_name);
+	GET(surfaceGetDeviceScale, cairo_surface_get_device_scale);
+	GET(surfaceSetDeviceScale, cairo_surface_set_device_scale);
 	dlclose(handle);
+	g_once_init_leave(&loaded, 1);
 }
 
 PangoAttribute *uiprivFUTURE_pango_attr_font_features_new(const gchar *features)
@@ -58,3 +72,19 @@ gboolean uiprivFUTURE_gtk_widget_path_iter_set_object_name(GtkWidgetPath *path,
 	(*gwpIterSetObjectName)(path, pos, name);
 	return TRUE;
 }
+
+gboolean uiprivFUTURE_cairo_surface_get_device_scale(cairo_surface_t *surface, double *xScale, double *yScale)
+{
+	if (surfaceGetDeviceScale == NULL)
+		return FALSE;
+	(*surfaceGetDeviceScale)(surface, xScale, yScale);
+	return TRUE;
+}
+
+gboolean uiprivFUTURE_cairo_surface_set_device_scale(cairo_surface_t *surface, double xScale, double yScale)
+{
+	if (surfaceSetDeviceScale == NULL)
+		return FALSE;
+	(*surfaceSetDeviceScale)(surface, xScale, yScale);
+	return TRUE;
+}
@@ -0,0 +1,167 @@
+// 18 october 2026
+#include "uipriv_unix.h"
+
+// every place where libui calls a handler of the program from the main loop wraps the call in uiprivDispatchBegin() and uiprivDispatchEnd(): control, window, and uiArea events, uiArea drawing and frames, timers, queued functions, scheduled work, fd watches, and the CellValue and SetCellValue methods of uiTableModelHandler
+// the exceptions are the other uiTableModelHandler methods, which only report sizes and types, and uiWorkerSubmit() done functions, which run inside the queued call that delivers them and are counted as part of it
+// the dispatches form a stack on the main thread's C stack, since a handler can run a nested main loop that dispatches more handlers
+// while recording is off, a dispatch costs two pointer assignments and a check; while it's on, it also reads the monotonic clock twice
+// the histograms are log2-bucketed, so recording a sample is O(1) and the whole thing fits in a few kilobytes no matter how long the program runs
+// all of this is main-thread only, except that uiQueueMain() checks uiprivLatencyOn from any thread to decide whether to timestamp what it queues, and the watchdog reads uiprivActiveDispatch
+
+#define nKinds (uiLatencyKindFDWatch + 1)
+
+static const char *kindNames[nKinds] = {
+	[uiLatencyKindQueueWait] = "queue wait",
+	[uiLatencyKindQueuedCall] = "queued calls",
+	[uiLatencyKindTimer] = "timers",
+	[uiLatencyKindScheduledWork] = "scheduled work",
+	[uiLatencyKindDraw] = "Draw",
+	[uiLatencyKindCellValue] = "CellValue",
+	[uiLatencyKindControlEvent] = "control events",
+	[uiLatencyKindFDWatch] = "fd watches",
+};
+
+static uiLatencyHistogram histograms[nKinds];
+// what the longest sample of each histogram was measuring
+static const char *slowest[nKinds];
+
+// only touched with atomic operations
+gint uiprivLatencyOn = FALSE;
+
+static uiprivDispatch *current = NULL;
+// the what of current, for the watchdog thread; only touched with atomic operations
+gpointer uiprivActiveDispatch = NULL;
+
+void uiprivDispatchBegin(uiprivDispatch *d, uiLatencyKind kind, const char *what)
+{
+	d->kind = kind;
+	d->what = what;
+	d->start = 0;
+	if (uiprivLatencyOn)
+		d->start = g_get_monotonic_time();
+	d->outer = current;
+	current = d;
+	g_atomic_pointer_set(&uiprivActiveDispatch, (gpointer) what);
+}
+
+void uiprivDispatchEnd(uiprivDispatch *d)
+{
+	current = d->outer;
+	if (current != NULL)
+		g_atomic_pointer_set(&uiprivActiveDispatch, (gpointer) (current->what));
+	else
+		g_atomic_pointer_set(&uiprivActiveDispatch, NULL);
+	// if recording was turned on during the dispatch, there's no start time to measure from
+	if (d->start != 0)
+		uiprivLatencyRecord(d->kind, g_get_monotonic_time() - d->start, d->what);
+}
+
+void uiprivLatencyRecord(uiLatencyKind kind, gint64 microseconds, const char *what)
+{
+	uiLatencyHistogram *h = &histograms[kind];
+	guint bucket;
+
+	if (microseconds < 0)
+		microseconds = 0;
+	// g_bit_storage() is floor(log2(n)) + 1, and 1 for 0
+	bucket = g_bit_storage((gulong) microseconds) - 1;
+	if (bucket >= uiLatencyHistogramBuckets)
+		bucket = uiLatencyHistogramBuckets - 1;
+	h->Buckets[bucket]++;
+	h->Count++;
+	h->TotalMicroseconds += (double) microseconds;
+	if ((double) microseconds >= h->MaxMicroseconds) {
+		h->MaxMicroseconds = (double) microseconds;
+		slowest[kind] = what;
+	}
+}
+
+void uiLatencyEnable(int enable)
+{
+	g_atomic_int_set(&uiprivLatencyOn, enable != 0);
+}
+
+void uiLatencyGetHistogram(uiLatencyKind kind, uiLatencyHistogram *h)
+{
+	if ((int) kind < 0 || kind >= nKinds)
+		uiprivUserBug("Invalid latency kind %d passed to uiLatencyGetHistogram().", (int) kind);
+	*h = histograms[kind];
+}
+
+void uiLatencyReset(void)
+{
+	memset(histograms, 0, sizeof (histograms));
+	memset(slowest, 0, sizeof (slowest));
+}
+
+// since the buckets are powers of two, this is only accurate to within a factor of two; the upper bound of the bucket is returned so the estimate errs on the slow side
+static double percentile(const uiLatencyHistogram *h, double p)
+{
+	size_t want, seen;
+	int i;
+
+	want = (size_t) (p * (double) (h->Count));
+	if (want == 0)
+		want = 1;
+	seen = 0;
+	for (i = 0; i < uiLatencyHistogramBuckets - 1; i++) {
+		seen += h->Buckets[i];
+		if (seen >= want)
+			return (double) (G_GINT64_CONSTANT(2) << i);
+	}
+	return h->MaxMicroseconds;
+}
+
+void uiLatencyDump(void)
+{
+	const uiLatencyHistogram *h;
+	int i;
+
+	if (!uiprivLatencyOn)
+		g_printerr("[libui] latency: recording is off\n");
+	g_printerr("[libui] %-16s %10s %10s %10s %10s %10s  %s\n", "latency (us)", "count", "mean", "p50 <", "p99 <", "max", "slowest");
+	for (i = 0; i < nKinds; i++) {
+		h = &histograms[i];
+		if (h->Count == 0)
+			continue;
+		g_printerr("[libui] %-16s %10" G_GSIZE_FORMAT " %10.0f %10.0f %10.0f %10.0f  %s\n",
+			kindNames[i], h->Count,
+			h->TotalMicroseconds / (double) (h->Count),
+			percentile(h, 0.50), percentile(h, 0.99), h->MaxMicroseconds,
+			slowest[i] != NULL ? slowest[i] : "");
+	}
+}
+
+// setting LIBUI_LATENCY to a number of seconds turns recording on and dumps the histograms that often, so operators can watch a running program
+static guint dumpTimer = 0;
+
+static gboolean periodicDump(gpointer data)
+{
+	uiLatencyDump();
+	return TRUE;
+}
+
+void uiprivInitLatency(void)
+{
+	const char *env;
+	int seconds;
+
+	uiLatencyReset();
+	env = g_getenv("LIBUI_LATENCY");
+	if (env == NULL)
+		return;
+	seconds = atoi(env);
+	if (seconds <= 0)
+		return;
+	uiLatencyEnable(TRUE);
+	dumpTimer = g_timeout_add_seconds(seconds, periodicDump, NULL);
+}
+
+void uiprivUninitLatency(void)
+{
+	if (dumpTimer != 0) {
+		g_source_remove(dumpTimer);
+		dumpTimer = 0;
+	}
+	uiLatencyEnable(FALSE);
+}
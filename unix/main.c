@@ -3,7 +3,8 @@
 
 uiInitOptions uiprivOptions;
 
-static GHashTable *timers;
+static void initScheduler(void);
+static void uninitScheduler(void);
 
 const char *uiInit(uiInitOptions *o)
 {
@@ -17,23 +18,26 @@ const char *uiInit(uiInitOptions *o)
 		return msg;
 	}
 	uiprivInitAlloc();
+	uiprivInitLatency();
 	uiprivLoadFutures();
-	timers = g_hash_table_new(g_direct_hash, g_direct_equal);
+	uiprivInitQueue();
+	uiprivInitTimers();
+	initScheduler();
+	uiprivInitWatchdog();
 	return NULL;
 }
 
-struct timer;		// TODO get rid of forward declaration
-
-static void uninitTimer(gpointer key, gpointer value, gpointer data)
-{
-	uiprivFree((struct timer *) key);
-}
-
 void uiUninit(void)
 {
-	g_hash_table_foreach(timers, uninitTimer, NULL);
-	g_hash_table_destroy(timers);
+	uiprivUninitWatchdog();
+	uiprivUninitWorkers();
+	uninitScheduler();
+	uiprivUninitTimers();
+	uiprivUninitQueue();
 	uiprivUninitMenus();
+	uiprivUninitGradientCache();
+	uiprivUninitFrameArena();
+	uiprivUninitLatency();
 	uiprivUninitAlloc();
 }
 
@@ -93,56 +97,119 @@ void uiQuit(void)
 	gdk_threads_add_idle(quit, NULL);
 }
 
-struct queued {
-	void (*f)(void *);
+// uiScheduleWork() runs long jobs a slice at a time, in the gaps between input and redraws
+// all jobs share one idle-priority GSource; each time it runs, it goes round-robin through the jobs until they're done or the budget for the current period is used up, then sleeps until the next period starts
+// because the source is at idle priority, pending input and redraws always go first
+
+struct job {
+	int (*f)(void *);
 	void *data;
 };
 
-static gboolean doqueued(gpointer data)
-{
-	struct queued *q = (struct queued *) data;
-
-	(*(q->f))(q->data);
-	g_free(q);
-	return FALSE;
-}
+static GQueue jobs = G_QUEUE_INIT;
+static GSource *schedulerSource;
+static gint64 schedulerBudget = 4000;
+static gint64 schedulerPeriod = 16667;
+// monotonic time in microseconds
+static gint64 periodStart = 0;
+static gint64 periodUsed = 0;
+static uiSchedulerStats schedulerStats;
 
-void uiQueueMain(void (*f)(void *data), void *data)
+static gboolean runJobs(GSource *s, GSourceFunc callback, gpointer data)
 {
-	struct queued *q;
-
-	// we have to use g_new0()/g_free() because uiprivAlloc() is only safe to call on the main thread
-	// for some reason it didn't affect me, but it did affect krakjoe
-	q = g_new0(struct queued, 1);
-	q->f = f;
-	q->data = data;
-	gdk_threads_add_idle(doqueued, q);
+	struct job *j;
+	gint64 start, now;
+	uiprivDispatch d;
+	int more;
+
+	now = g_get_monotonic_time();
+	if (now - periodStart >= schedulerPeriod) {
+		periodStart = now;
+		periodUsed = 0;
+		schedulerStats.Periods++;
+	}
+	start = now;
+	while (!g_queue_is_empty(&jobs) && periodUsed + (now - start) < schedulerBudget) {
+		j = (struct job *) g_queue_pop_head(&jobs);
+		schedulerStats.Slices++;
+		uiprivDispatchBegin(&d, uiLatencyKindScheduledWork, "uiScheduleWork() job");
+		more = (*(j->f))(j->data);
+		uiprivDispatchEnd(&d);
+		if (more)
+			g_queue_push_tail(&jobs, j);
+		else {
+			uiprivPoolDelete(struct job, j);
+			schedulerStats.CompletedJobs++;
+		}
+		now = g_get_monotonic_time();
+	}
+	periodUsed += now - start;
+	schedulerStats.TotalMicroseconds += (double) (now - start);
+	schedulerStats.LastPeriodMicroseconds = (double) periodUsed;
+
+	if (g_queue_is_empty(&jobs))
+		g_source_set_ready_time(s, -1);
+	else {
+		// if we're here, the budget ran out with work left over
+		schedulerStats.ExhaustedPeriods++;
+		g_source_set_ready_time(s, periodStart + schedulerPeriod);
+	}
+	return G_SOURCE_CONTINUE;
 }
 
-struct timer {
-	int (*f)(void *);
-	void *data;
+static GSourceFuncs schedulerFuncs = {
+	.dispatch = runJobs,
 };
 
-static gboolean doTimer(gpointer data)
+static void initScheduler(void)
 {
-	struct timer *t = (struct timer *) data;
+	memset(&schedulerStats, 0, sizeof (uiSchedulerStats));
+	// start a new period with the first job, rather than carry on one from before the last uiUninit()
+	periodStart = 0;
+	periodUsed = 0;
+	schedulerSource = g_source_new(&schedulerFuncs, sizeof (GSource));
+	g_source_set_name(schedulerSource, "libui uiScheduleWork()");
+	g_source_set_priority(schedulerSource, G_PRIORITY_DEFAULT_IDLE);
+	g_source_set_ready_time(schedulerSource, -1);
+	g_source_attach(schedulerSource, NULL);
+}
 
-	if (!(*(t->f))(t->data)) {
-		g_hash_table_remove(timers, t);
-		uiprivFree(t);
-		return FALSE;
-	}
-	return TRUE;
+static void uninitScheduler(void)
+{
+	struct job *j;
+
+	// jobs that didn't finish are dropped
+	while ((j = (struct job *) g_queue_pop_head(&jobs)) != NULL)
+		uiprivPoolDelete(struct job, j);
+	g_source_destroy(schedulerSource);
+	g_source_unref(schedulerSource);
+	schedulerSource = NULL;
 }
 
-void uiTimer(int milliseconds, int (*f)(void *data), void *data)
+void uiScheduleWork(int (*f)(void *data), void *data)
 {
-	struct timer *t;
+	struct job *j;
+
+	j = uiprivPoolNew(struct job);
+	j->f = f;
+	j->data = data;
+	g_queue_push_tail(&jobs, j);
+	// if the source is already waiting for the next period, leave it be
+	if (g_source_get_ready_time(schedulerSource) == -1)
+		g_source_set_ready_time(schedulerSource, 0);
+}
 
-	t = uiprivNew(struct timer);
-	t->f = f;
-	t->data = data;
-	g_timeout_add(milliseconds, doTimer, t);
-	g_hash_table_add(timers, t);
+void uiSchedulerSetBudget(int budgetMicroseconds, int periodMicroseconds)
+{
+	if (budgetMicroseconds <= 0 || periodMicroseconds < budgetMicroseconds)
+		uiprivUserBug("Invalid budget %d and period %d passed to uiSchedulerSetBudget(); the budget must be positive and no longer than the period.", budgetMicroseconds, periodMicroseconds);
+	schedulerBudget = budgetMicroseconds;
+	schedulerPeriod = periodMicroseconds;
+}
+
+void uiSchedulerGetStats(uiSchedulerStats *stats)
+{
+	*stats = schedulerStats;
+	stats->PendingJobs = (int) g_queue_get_length(&jobs);
+	stats->BudgetMicroseconds = (double) schedulerBudget;
 }
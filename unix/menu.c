@@ -64,6 +64,8 @@ static void onClicked(GtkMenuItem *menuitem, gpointer data)
 {
 	uiMenuItem *item = uiMenuItem(data);
 	struct menuItemWindow *w;
+	uiprivDispatch dispatch;
+	const char *what;
 
 	// we need to manually update the checked states of all menu items if one changes
 	// notice that this is getting the checked state of the menu item that this signal is sent from
@@ -71,7 +73,13 @@ static void onClicked(GtkMenuItem *menuitem, gpointer data)
 		setChecked(item, gtk_check_menu_item_get_active(GTK_CHECK_MENU_ITEM(menuitem)));
 
 	w = (struct menuItemWindow *) g_hash_table_lookup(item->windows, menuitem);
+	// the handler of a Quit item is ours, and all it does is call the program's uiOnShouldQuit() handler
+	what = "uiMenuItem OnClicked";
+	if (item->type == typeQuit)
+		what = "uiOnShouldQuit() handler";
+	uiprivDispatchBegin(&dispatch, uiLatencyKindControlEvent, what);
 	(*(item->onClicked))(item, w->w, item->onClickedData);
+	uiprivDispatchEnd(&dispatch);
 }
 
 static void defaultOnClicked(uiMenuItem *item, uiWindow *w, void *data)
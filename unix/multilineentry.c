@@ -21,8 +21,11 @@ uiUnixControlAllDefaults(uiMultilineEntry)
 static void onChanged(GtkTextBuffer *textbuf, gpointer data)
 {
 	uiMultilineEntry *e = uiMultilineEntry(data);
+	uiprivDispatch dispatch;
 
+	uiprivDispatchBegin(&dispatch, uiLatencyKindControlEvent, "uiMultilineEntry OnChanged");
 	(*(e->onChanged))(e, e->onChangedData);
+	uiprivDispatchEnd(&dispatch);
 }
 
 static void defaultOnChanged(uiMultilineEntry *e, void *data)
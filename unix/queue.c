@@ -0,0 +1,308 @@
+// 18 october 2026
+#include "uipriv_unix.h"
+
+// uiQueueMain() can be called from any thread, often thousands of times a second, so instead of creating a GSource for every call, calls are pushed onto a lock-free stack and a single long-lived GSource runs them in batches
+// producers push with a compare-and-swap; the main thread takes the whole stack at once by swapping in NULL, which can't suffer from the ABA problem because it never looks at what it replaces
+// the stack comes out newest first, so each batch is reversed before it runs to keep calls in the order they were made
+// a producer only has to wake the main loop when it pushes onto an empty stack; otherwise a wakeup is already on its way
+// there is one such queue and GSource for every uiQueuePriority
+
+struct node {
+	struct node *next;
+	void (*f)(void *);
+	void *data;
+	// when the call was queued, if latency recording was on; 0 otherwise
+	gint64 queued;
+};
+
+struct queue {
+	// only touched with atomic operations
+	struct node *pending;
+	// the calls taken from pending that haven't run yet, oldest first; only touched on the main thread
+	// these are kept here instead of in a local variable so that if a call runs a nested main loop (for instance, with uiMsgBox()), the nested loop carries on with the same batch in the same order
+	struct node *ready;
+	struct node *readyLast;
+	GSource *source;
+};
+
+struct queueSource {
+	GSource source;
+	struct queue *q;
+};
+
+#define nQueues 3
+static struct queue queues[nQueues];
+
+// GDK handles input at G_PRIORITY_DEFAULT, then does layout and redraws at G_PRIORITY_HIGH_IDLE + 10 and + 20
+static const gint queuePriorities[nQueues] = {
+	[uiQueuePriorityHigh] = G_PRIORITY_HIGH_IDLE,		// after input, but before the next frame
+	[uiQueuePriorityNormal] = G_PRIORITY_DEFAULT_IDLE,	// after the next frame; the same priority gdk_threads_add_idle() used
+	[uiQueuePriorityBackground] = G_PRIORITY_LOW,		// only when there is nothing else to do
+};
+
+// nodes are never freed while libui is running; after a batch has run, the main thread pushes its nodes onto recycled in one go, and a producer that runs out of nodes takes all of recycled for itself
+// that doesn't need a lock either, and after a while every thread that queues a lot has enough nodes of its own that it stops allocating
+// these are g_new()'d rather than uiprivNew()'d because a thread's leftover nodes are only freed when the thread exits, which can be after uiUninit()
+static struct node *recycled = NULL;
+
+static void freeNodes(gpointer data)
+{
+	struct node *n, *next;
+
+	for (n = (struct node *) data; n != NULL; n = next) {
+		next = n->next;
+		g_free(n);
+	}
+}
+
+// the calling thread's own nodes
+static GPrivate cacheKey = G_PRIVATE_INIT(freeNodes);
+
+static struct node *takeAll(struct node **stack)
+{
+	struct node *n;
+
+	do
+		n = (struct node *) g_atomic_pointer_get(stack);
+	while (n != NULL && !g_atomic_pointer_compare_and_exchange(stack, n, NULL));
+	return n;
+}
+
+// returns whether the stack was empty
+static gboolean pushAll(struct node **stack, struct node *first, struct node *last)
+{
+	struct node *old;
+
+	do {
+		old = (struct node *) g_atomic_pointer_get(stack);
+		last->next = old;
+	} while (!g_atomic_pointer_compare_and_exchange(stack, old, first));
+	return old == NULL;
+}
+
+static struct node *newNode(void)
+{
+	struct node *n;
+
+	n = (struct node *) g_private_get(&cacheKey);
+	if (n == NULL)
+		n = takeAll(&recycled);
+	if (n == NULL)
+		return g_new(struct node, 1);
+	g_private_set(&cacheKey, n->next);
+	return n;
+}
+
+static gboolean queuePrepare(GSource *s, gint *timeout)
+{
+	struct queue *q = ((struct queueSource *) s)->q;
+
+	*timeout = -1;
+	return q->ready != NULL || g_atomic_pointer_get(&(q->pending)) != NULL;
+}
+
+static gboolean queueCheck(GSource *s)
+{
+	struct queue *q = ((struct queueSource *) s)->q;
+
+	return q->ready != NULL || g_atomic_pointer_get(&(q->pending)) != NULL;
+}
+
+static gboolean queueDispatch(GSource *s, GSourceFunc callback, gpointer data)
+{
+	struct queue *q = ((struct queueSource *) s)->q;
+	struct node *n, *next, *reversed, *first;
+	struct node *done, *doneLast;
+	void (*f)(void *);
+	void *fdata;
+	uiprivDispatch d;
+
+	reversed = NULL;
+	first = takeAll(&(q->pending));
+	for (n = first; n != NULL; n = next) {
+		next = n->next;
+		n->next = reversed;
+		reversed = n;
+	}
+	if (reversed != NULL) {
+		if (q->ready == NULL)
+			q->ready = reversed;
+		else
+			q->readyLast->next = reversed;
+		q->readyLast = first;
+	}
+
+	done = NULL;
+	doneLast = NULL;
+	while (q->ready != NULL) {
+		n = q->ready;
+		q->ready = n->next;
+		if (q->ready == NULL)
+			q->readyLast = NULL;
+		f = n->f;
+		fdata = n->data;
+		if (n->queued != 0)
+			uiprivLatencyRecord(uiLatencyKindQueueWait, g_get_monotonic_time() - n->queued, NULL);
+		n->next = done;
+		done = n;
+		if (doneLast == NULL)
+			doneLast = n;
+		uiprivDispatchBegin(&d, uiLatencyKindQueuedCall, "uiQueueMain() function");
+		(*f)(fdata);
+		uiprivDispatchEnd(&d);
+	}
+	if (done != NULL)
+		pushAll(&recycled, done, doneLast);
+	return G_SOURCE_CONTINUE;
+}
+
+static GSourceFuncs queueFuncs = {
+	.prepare = queuePrepare,
+	.check = queueCheck,
+	.dispatch = queueDispatch,
+};
+
+// uiQueueMainKeyed() keeps at most one pending call per key; posting again before the main thread gets to it just swaps in the new call
+// the keyed calls still go through the queue above, one node per key, so they keep their place relative to ordinary calls
+
+struct keyed {
+	const void *key;
+	void (*f)(void *);
+	void *data;
+	void (*freeData)(void *);
+};
+
+// keyedLock protects keyedPending, and the fields of every struct keyed in it
+static GMutex keyedLock;
+static GHashTable *keyedPending = NULL;
+
+static void runKeyed(void *data)
+{
+	struct keyed *k = (struct keyed *) data;
+	void (*f)(void *);
+	void *fdata;
+
+	// once the call is out of the table, the next post with the same key queues a new one, which runs in the next batch
+	g_mutex_lock(&keyedLock);
+	g_hash_table_remove(keyedPending, k->key);
+	f = k->f;
+	fdata = k->data;
+	g_mutex_unlock(&keyedLock);
+	uiprivPoolDelete(struct keyed, k);
+	(*f)(fdata);
+}
+
+static void initKeyed(void)
+{
+	keyedPending = g_hash_table_new(g_direct_hash, g_direct_equal);
+}
+
+static void uninitKeyed(void)
+{
+	GHashTableIter iter;
+	gpointer value;
+	struct keyed *k;
+
+	// the nodes that point to these are freed without running by uiprivUninitQueue()
+	g_hash_table_iter_init(&iter, keyedPending);
+	while (g_hash_table_iter_next(&iter, NULL, &value)) {
+		k = (struct keyed *) value;
+		if (k->freeData != NULL)
+			(*(k->freeData))(k->data);
+		uiprivPoolDelete(struct keyed, k);
+	}
+	g_hash_table_destroy(keyedPending);
+	keyedPending = NULL;
+}
+
+void uiQueueMainKeyed(const void *key, void (*f)(void *data), void *data, void (*freeData)(void *data))
+{
+	struct keyed *k;
+	void *old;
+	void (*oldFree)(void *);
+
+	g_mutex_lock(&keyedLock);
+	k = (struct keyed *) g_hash_table_lookup(keyedPending, key);
+	if (k == NULL) {
+		k = uiprivPoolNew(struct keyed);
+		k->key = key;
+		k->f = f;
+		k->data = data;
+		k->freeData = freeData;
+		g_hash_table_insert(keyedPending, (gpointer) key, k);
+		g_mutex_unlock(&keyedLock);
+		uiQueueMain(runKeyed, k);
+		return;
+	}
+	old = k->data;
+	oldFree = k->freeData;
+	k->f = f;
+	k->data = data;
+	k->freeData = freeData;
+	g_mutex_unlock(&keyedLock);
+	// free outside the lock, in case freeData wants to queue something itself
+	if (oldFree != NULL)
+		(*oldFree)(old);
+}
+
+void uiprivInitQueue(void)
+{
+	struct queue *q;
+	int i;
+
+	initKeyed();
+	for (i = 0; i < nQueues; i++) {
+		q = &queues[i];
+		q->source = g_source_new(&queueFuncs, sizeof (struct queueSource));
+		((struct queueSource *) (q->source))->q = q;
+		g_source_set_name(q->source, "libui uiQueueMain()");
+		g_source_set_priority(q->source, queuePriorities[i]);
+		g_source_set_can_recurse(q->source, TRUE);
+		g_source_attach(q->source, NULL);
+	}
+}
+
+void uiprivUninitQueue(void)
+{
+	struct queue *q;
+	struct node *n;
+	int i;
+
+	uninitKeyed();
+	for (i = 0; i < nQueues; i++) {
+		q = &queues[i];
+		g_source_destroy(q->source);
+		g_source_unref(q->source);
+		q->source = NULL;
+		// calls that never got to run are dropped, just like idle sources that are still pending when the program ends
+		freeNodes(q->ready);
+		q->ready = NULL;
+		q->readyLast = NULL;
+		freeNodes(takeAll(&(q->pending)));
+	}
+	freeNodes(takeAll(&recycled));
+	n = (struct node *) g_private_get(&cacheKey);
+	g_private_set(&cacheKey, NULL);
+	freeNodes(n);
+}
+
+void uiQueueMainWithPriority(uiQueuePriority priority, void (*f)(void *data), void *data)
+{
+	struct node *n;
+
+	if ((int) priority < 0 || priority >= nQueues)
+		uiprivUserBug("Invalid priority %d passed to uiQueueMainWithPriority().", (int) priority);
+	n = newNode();
+	n->f = f;
+	n->data = data;
+	n->queued = 0;
+	if (g_atomic_int_get(&uiprivLatencyOn))
+		n->queued = g_get_monotonic_time();
+	if (pushAll(&(queues[priority].pending), n, n))
+		g_main_context_wakeup(NULL);
+}
+
+void uiQueueMain(void (*f)(void *data), void *data)
+{
+	uiQueueMainWithPriority(uiQueuePriorityNormal, f, data);
+}
@@ -24,6 +24,7 @@ static void defaultOnSelected(uiRadioButtons *r, void *data)
 static void onToggled(GtkToggleButton *tb, gpointer data)
 {
 	uiRadioButtons *r = uiRadioButtons(data);
+	uiprivDispatch dispatch;
 
 	// only care if a button is selected
 	if (!gtk_toggle_button_get_active(tb))
@@ -31,7 +32,9 @@ static void onToggled(GtkToggleButton *tb, gpointer data)
 	// ignore programmatic changes
 	if (r->changing)
 		return;
+	uiprivDispatchBegin(&dispatch, uiLatencyKindControlEvent, "uiRadioButtons OnSelected");
 	(*(r->onSelected))(r, r->onSelectedData);
+	uiprivDispatchEnd(&dispatch);
 }
 
 static void uiRadioButtonsDestroy(uiControl *c)
@@ -31,8 +31,11 @@ static void _uiSliderUpdateToolTip(uiSlider *s)
 static void onChanged(GtkRange *range, gpointer data)
 {
 	uiSlider *s = uiSlider(data);
+	uiprivDispatch dispatch;
 
+	uiprivDispatchBegin(&dispatch, uiLatencyKindControlEvent, "uiSlider OnChanged");
 	(*(s->onChanged))(s, s->onChangedData);
+	uiprivDispatchEnd(&dispatch);
 
 	if (uiSliderHasToolTip(s))
 		_uiSliderUpdateToolTip(s);
@@ -46,8 +49,11 @@ static void defaultOnChanged(uiSlider *s, void *data)
 static gboolean onReleased(GtkWidget *w, GdkEventButton *event, gpointer data)
 {
 	uiSlider *s = uiSlider(data);
+	uiprivDispatch dispatch;
 
+	uiprivDispatchBegin(&dispatch, uiLatencyKindControlEvent, "uiSlider OnReleased");
 	(*(s->onReleased))(s, s->onReleasedData);
+	uiprivDispatchEnd(&dispatch);
 	return FALSE;
 }
 
@@ -16,8 +16,11 @@ uiUnixControlAllDefaults(uiSpinbox)
 static void onChanged(GtkSpinButton *sb, gpointer data)
 {
 	uiSpinbox *s = uiSpinbox(data);
+	uiprivDispatch dispatch;
 
+	uiprivDispatchBegin(&dispatch, uiLatencyKindControlEvent, "uiSpinbox OnChanged");
 	(*(s->onChanged))(s, s->onChangedData);
+	uiprivDispatchEnd(&dispatch);
 }
 
 static void defaultOnChanged(uiSpinbox *s, void *data)
@@ -95,13 +95,16 @@ static void onEdited(uiTableModel *m, int column, const char *pathstr, const uiT
 {
 	GtkTreePath *path;
 	int row;
+	uiprivDispatch dispatch;
 
 	path = gtk_tree_path_new_from_string(pathstr);
 	row = gtk_tree_path_get_indices(path)[0];
 	if (iter != NULL)
 		gtk_tree_model_get_iter(GTK_TREE_MODEL(m), iter, path);
 	gtk_tree_path_free(path);
+	uiprivDispatchBegin(&dispatch, uiLatencyKindControlEvent, "uiTableModelHandler SetCellValue");
 	uiprivTableModelSetCellValue(m, row, column, tvalue);
+	uiprivDispatchEnd(&dispatch);
 }
 
 struct textColumnParams {
@@ -391,10 +394,14 @@ static void headerOnClicked(GtkTreeViewColumn *c, gpointer data)
 {
 	guint i;
 	uiTable *t = uiTable(data);
+	uiprivDispatch dispatch;
 
 	for (i = 0; i < gtk_tree_view_get_n_columns(t->tv); ++i)
-		if (gtk_tree_view_get_column(t->tv, i) == c)
+		if (gtk_tree_view_get_column(t->tv, i) == c) {
+			uiprivDispatchBegin(&dispatch, uiLatencyKindControlEvent, "uiTable HeaderOnClicked");
 			t->headerOnClicked(t, i, t->headerOnClickedData);
+			uiprivDispatchEnd(&dispatch);
+		}
 }
 
 void uiTableOnSelectionChanged(uiTable *t, void (*f)(uiTable *t, void *data), void *data)
@@ -466,13 +473,16 @@ static gboolean selectionChanged(uiTable *t, GtkTreeSelection *s)
 static void onSelectionChanged(GtkTreeSelection *s, gpointer data)
 {
 	uiTable *t = uiTable(data);
+	uiprivDispatch dispatch;
 
 	// Abort if the row is already selected. See upstream bug:
 	// https://gitlab.gnome.org/GNOME/gtk/-/issues/5061
 	if (!selectionChanged(t, s))
 		return;
 
+	uiprivDispatchBegin(&dispatch, uiLatencyKindControlEvent, "uiTable OnSelectionChanged");
 	t->onSelectionChanged(t, t->onSelectionChangedData);
+	uiprivDispatchEnd(&dispatch);
 }
 
 uiTableSelection* uiTableGetSelection(uiTable *t)
@@ -735,6 +745,7 @@ static void onButtonPressed(GtkGestureMultiPress *gesture, gint nPress, gdouble
 	uiTable *t = uiTable(data);
 	GtkTreePath *path;
 	gint row, x, y;
+	uiprivDispatch dispatch;
 
 	gtk_tree_view_convert_widget_to_bin_window_coords(t->tv, wx, wy, &x, &y);
 	gtk_tree_view_get_path_at_pos(GTK_TREE_VIEW(t->tv), x, y, &path, NULL, NULL, NULL);
@@ -744,10 +755,15 @@ static void onButtonPressed(GtkGestureMultiPress *gesture, gint nPress, gdouble
 	row = gtk_tree_path_get_indices(path)[0];
 	gtk_tree_path_free(path);
 
-	if (nPress == 1)
+	if (nPress == 1) {
+		uiprivDispatchBegin(&dispatch, uiLatencyKindControlEvent, "uiTable OnRowClicked");
 		(*(t->onRowClicked))(t, row, t->onRowClickedData);
-	else if (nPress == 2)
+		uiprivDispatchEnd(&dispatch);
+	} else if (nPress == 2) {
+		uiprivDispatchBegin(&dispatch, uiLatencyKindControlEvent, "uiTable OnRowDoubleClicked");
 		(*(t->onRowDoubleClicked))(t, row, t->onRowDoubleClickedData);
+		uiprivDispatchEnd(&dispatch);
+	}
 }
 #else
 static gboolean onButtonPressed(GtkWidget *tv, GdkEventButton *event, gpointer data)
@@ -755,6 +771,7 @@ static gboolean onButtonPressed(GtkWidget *tv, GdkEventButton *event, gpointer d
 	uiTable *t = uiTable(data);
 	GtkTreePath *path;
 	gint row;
+	uiprivDispatch dispatch;
 
 	if (event->window != gtk_tree_view_get_bin_window(t->tv))
 		return FALSE;
@@ -768,10 +785,15 @@ static gboolean onButtonPressed(GtkWidget *tv, GdkEventButton *event, gpointer d
 	row = gtk_tree_path_get_indices(path)[0];
 	gtk_tree_path_free(path);
 
-	if (event->type == GDK_BUTTON_PRESS)
+	if (event->type == GDK_BUTTON_PRESS) {
+		uiprivDispatchBegin(&dispatch, uiLatencyKindControlEvent, "uiTable OnRowClicked");
 		(*(t->onRowClicked))(t, row, t->onRowClickedData);
-	else if (event->type == GDK_2BUTTON_PRESS)
+		uiprivDispatchEnd(&dispatch);
+	} else if (event->type == GDK_2BUTTON_PRESS) {
+		uiprivDispatchBegin(&dispatch, uiLatencyKindControlEvent, "uiTable OnRowDoubleClicked");
 		(*(t->onRowDoubleClicked))(t, row, t->onRowDoubleClickedData);
+		uiprivDispatchEnd(&dispatch);
+	}
 
 	return FALSE;
 }
@@ -92,11 +92,14 @@ static void uiTableModel_get_value(GtkTreeModel *mm, GtkTreeIter *iter, gint col
 	uiTableValue *tvalue;
 	double r, g, b, a;
 	GdkRGBA rgba;
+	uiprivDispatch d;
 
 	g_return_if_fail(iter->stamp == m->stamp);
 
 	row = GPOINTER_TO_INT(iter->user_data);
+	uiprivDispatchBegin(&d, uiLatencyKindCellValue, "uiTableModelHandler CellValue");
 	tvalue = uiprivTableModelCellValue(m, row, column);
+	uiprivDispatchEnd(&d);
 	switch (uiprivTableModelColumnType(m, column)) {
 	case uiTableValueTypeString:
 		g_value_init(value, G_TYPE_STRING);
@@ -0,0 +1,286 @@
+// 18 october 2026
+#include "uipriv_unix.h"
+
+// all timers share one GSource instead of having a g_timeout_add() each
+// the timers are kept in a binary min-heap ordered by deadline, and the source's ready time is always the deadline at the top of the heap, so no matter how many timers there are, the main loop only ever waits on one of them
+// deadlines are in microseconds of g_get_monotonic_time(); GLib rounds the poll timeout up to the next millisecond, so timers never fire early
+// g_timeout_add() schedules the next tick from when the last one was dispatched, so timers drift by however late each dispatch was; the fixed-rate modes schedule from the last deadline instead
+// a timer callback can run a nested main loop (a modal dialog, say), and the other timers have to keep firing in it, just as they did with a source each; so the source can recurse, and a dispatch takes timers out of the heap one at a time, only while running them, so everything else stays where a nested dispatch can find it
+
+struct timer {
+	uiTimerID id;
+	uiTimerMode mode;
+	gint64 interval;
+	gint64 deadline;
+	int (*f)(void *);
+	void *data;
+	// position in the heap, or -1 while the timer is out of the heap to be run
+	gint index;
+	// the dispatch that last ran the timer; see runTimers()
+	guint64 lastRun;
+	gboolean cancelled;
+	gboolean rescheduled;
+};
+
+static GPtrArray *heap;
+static GHashTable *timers;			// uiTimerID -> struct timer *
+static uiTimerID nextID = 1;
+static GSource *timerSource;
+// counts dispatches, nested or not
+static guint64 dispatches = 0;
+// bumped by uiprivUninitTimers(), so a dispatch that uiUninit() was called from knows its timers are gone
+static guint generation = 0;
+
+#define at(i) ((struct timer *) g_ptr_array_index(heap, (i)))
+
+static void place(struct timer *t, gint i)
+{
+	g_ptr_array_index(heap, i) = t;
+	t->index = i;
+}
+
+static void siftUp(gint i)
+{
+	struct timer *t;
+	gint parent;
+
+	t = at(i);
+	while (i > 0) {
+		parent = (i - 1) / 2;
+		if (at(parent)->deadline <= t->deadline)
+			break;
+		place(at(parent), i);
+		i = parent;
+	}
+	place(t, i);
+}
+
+static void siftDown(gint i)
+{
+	struct timer *t;
+	gint n, child;
+
+	t = at(i);
+	n = (gint) (heap->len);
+	for (;;) {
+		child = 2 * i + 1;
+		if (child >= n)
+			break;
+		if (child + 1 < n && at(child + 1)->deadline < at(child)->deadline)
+			child++;
+		if (t->deadline <= at(child)->deadline)
+			break;
+		place(at(child), i);
+		i = child;
+	}
+	place(t, i);
+}
+
+static void heapPush(struct timer *t)
+{
+	g_ptr_array_add(heap, t);
+	siftUp((gint) (heap->len - 1));
+}
+
+static void heapRemove(struct timer *t)
+{
+	struct timer *last;
+	gint i;
+
+	i = t->index;
+	last = at(heap->len - 1);
+	g_ptr_array_set_size(heap, heap->len - 1);
+	t->index = -1;
+	if (last == t)
+		return;
+	place(last, i);
+	// the moved timer could belong either above or below its new spot
+	siftUp(i);
+	siftDown(last->index);
+}
+
+static void updateReadyTime(void)
+{
+	if (heap->len == 0)
+		g_source_set_ready_time(timerSource, -1);
+	else
+		g_source_set_ready_time(timerSource, at(0)->deadline);
+}
+
+static void freeTimer(struct timer *t)
+{
+	g_hash_table_remove(timers, GUINT_TO_POINTER(t->id));
+	uiprivPoolDelete(struct timer, t);
+}
+
+static void scheduleNext(struct timer *t, gint64 now)
+{
+	gint64 missed;
+
+	switch (t->mode) {
+	case uiTimerModeFixedDelay:
+		t->deadline = now + t->interval;
+		break;
+	case uiTimerModeFixedRate:
+		t->deadline += t->interval;
+		// skip the ticks we missed, but stay in phase
+		if (t->deadline <= now) {
+			missed = (now - t->deadline) / t->interval + 1;
+			t->deadline += missed * t->interval;
+		}
+		break;
+	case uiTimerModeFixedRateCatchUp:
+		// if this is still in the past, the timer fires again on the next dispatch, after anything else that's pending has had a chance to run
+		t->deadline += t->interval;
+		break;
+	}
+}
+
+static gboolean runTimers(GSource *s, GSourceFunc callback, gpointer data)
+{
+	struct timer *t;
+	gint64 now;
+	guint64 self;
+	guint gen;
+	uiprivDispatch d;
+
+	self = ++dispatches;
+	gen = generation;
+	// each timer fires at most once per dispatch, even if it's already due again (as a uiTimerModeFixedRateCatchUp timer that is behind will be); the ones that are left go on the next dispatch, after anything else that's pending has had a chance to run
+	now = g_get_monotonic_time();
+	while (heap->len != 0 && at(0)->deadline <= now && at(0)->lastRun != self) {
+		t = at(0);
+		heapRemove(t);
+		t->lastRun = self;
+		uiprivDispatchBegin(&d, uiLatencyKindTimer, "uiTimer() callback");
+		if (!(*(t->f))(t->data))
+			t->cancelled = TRUE;
+		uiprivDispatchEnd(&d);
+		// uiUninit() was called from the callback and has freed every timer, this one included
+		if (generation != gen)
+			return G_SOURCE_REMOVE;
+		if (t->cancelled) {
+			freeTimer(t);
+			continue;
+		}
+		// uiTimerReschedule() from the callback has already set the next deadline
+		if (!t->rescheduled)
+			scheduleNext(t, g_get_monotonic_time());
+		t->rescheduled = FALSE;
+		heapPush(t);
+	}
+	updateReadyTime();
+	return G_SOURCE_CONTINUE;
+}
+
+static GSourceFuncs timerFuncs = {
+	.dispatch = runTimers,
+};
+
+void uiprivInitTimers(void)
+{
+	heap = g_ptr_array_new();
+	timers = g_hash_table_new(g_direct_hash, g_direct_equal);
+	timerSource = g_source_new(&timerFuncs, sizeof (GSource));
+	g_source_set_name(timerSource, "libui uiTimer()");
+	// the same priority g_timeout_add() uses
+	g_source_set_priority(timerSource, G_PRIORITY_DEFAULT);
+	g_source_set_ready_time(timerSource, -1);
+	g_source_set_can_recurse(timerSource, TRUE);
+	g_source_attach(timerSource, NULL);
+}
+
+static void uninitTimer(gpointer key, gpointer value, gpointer data)
+{
+	uiprivPoolDelete(struct timer, (struct timer *) value);
+}
+
+void uiprivUninitTimers(void)
+{
+	g_source_destroy(timerSource);
+	g_source_unref(timerSource);
+	timerSource = NULL;
+	// since timers use uiprivAlloc(), we have to clean them up here, or else we'll get dangling allocation errors
+	// every timer is in timers, whether it's in the heap or out of it being run
+	g_hash_table_foreach(timers, uninitTimer, NULL);
+	g_ptr_array_free(heap, TRUE);
+	g_hash_table_destroy(timers);
+	heap = NULL;
+	timers = NULL;
+	generation++;
+}
+
+static gint64 toInterval(double milliseconds, const char *func)
+{
+	gint64 interval;
+
+	if (milliseconds < 0)
+		uiprivUserBug("Negative interval %g passed to %s().", milliseconds, func);
+	interval = (gint64) (milliseconds * 1000);
+	// a zero interval would make the fixed-rate modes spin
+	if (interval < 1)
+		interval = 1;
+	return interval;
+}
+
+uiTimerID uiTimerStart(double milliseconds, uiTimerMode mode, int (*f)(void *data), void *data)
+{
+	struct timer *t;
+
+	if (mode != uiTimerModeFixedDelay && mode != uiTimerModeFixedRate && mode != uiTimerModeFixedRateCatchUp)
+		uiprivUserBug("Invalid timer mode %d passed to uiTimerStart().", (int) mode);
+	t = uiprivPoolNew(struct timer);
+	// IDs are 32 bits and can wrap around in a long-running program; skip 0 and any that are still in use
+	while (nextID == 0 || g_hash_table_contains(timers, GUINT_TO_POINTER(nextID)))
+		nextID++;
+	t->id = nextID++;
+	t->mode = mode;
+	t->interval = toInterval(milliseconds, "uiTimerStart");
+	t->deadline = g_get_monotonic_time() + t->interval;
+	t->f = f;
+	t->data = data;
+	g_hash_table_insert(timers, GUINT_TO_POINTER(t->id), t);
+	heapPush(t);
+	updateReadyTime();
+	return t->id;
+}
+
+void uiTimerCancel(uiTimerID id)
+{
+	struct timer *t;
+
+	t = (struct timer *) g_hash_table_lookup(timers, GUINT_TO_POINTER(id));
+	if (t == NULL)
+		return;
+	if (t->index == -1) {
+		// the timer is being run; runTimers() frees it when it's done
+		t->cancelled = TRUE;
+		return;
+	}
+	heapRemove(t);
+	freeTimer(t);
+	updateReadyTime();
+}
+
+void uiTimerReschedule(uiTimerID id, double milliseconds)
+{
+	struct timer *t;
+
+	t = (struct timer *) g_hash_table_lookup(timers, GUINT_TO_POINTER(id));
+	if (t == NULL || t->cancelled)
+		return;
+	t->interval = toInterval(milliseconds, "uiTimerReschedule");
+	t->deadline = g_get_monotonic_time() + t->interval;
+	if (t->index == -1) {
+		t->rescheduled = TRUE;
+		return;
+	}
+	siftUp(t->index);
+	siftDown(t->index);
+	updateReadyTime();
+}
+
+void uiTimer(int milliseconds, int (*f)(void *data), void *data)
+{
+	uiTimerStart(milliseconds, uiTimerModeFixedDelay, f, data);
+}
@@ -28,6 +28,53 @@ extern void uiprivUninitMenus(void);
 extern void uiprivInitAlloc(void);
 extern void uiprivUninitAlloc(void);
 
+// arena.c
+typedef struct uiprivArenaChunk uiprivArenaChunk;
+typedef struct uiprivArenaMark uiprivArenaMark;
+struct uiprivArenaMark {
+	uiprivArenaChunk *chunk;
+	size_t used;
+};
+extern void uiprivUninitFrameArena(void);
+extern uiprivArenaMark uiprivFrameArenaMark(void);
+extern void uiprivFrameArenaRelease(uiprivArenaMark m);
+extern void *uiprivFrameArenaAlloc(size_t size);
+#define uiprivFrameArenaNew(T) ((T *) uiprivFrameArenaAlloc(sizeof (T)))
+
+// queue.c
+extern void uiprivInitQueue(void);
+extern void uiprivUninitQueue(void);
+
+// timer.c
+extern void uiprivInitTimers(void);
+extern void uiprivUninitTimers(void);
+
+// latency.c
+typedef struct uiprivDispatch uiprivDispatch;
+struct uiprivDispatch {
+	uiLatencyKind kind;
+	const char *what;
+	gint64 start;
+	uiprivDispatch *outer;
+};
+extern gint uiprivLatencyOn;
+extern gpointer uiprivActiveDispatch;
+extern void uiprivInitLatency(void);
+extern void uiprivUninitLatency(void);
+extern void uiprivDispatchBegin(uiprivDispatch *d, uiLatencyKind kind, const char *what);
+extern void uiprivDispatchEnd(uiprivDispatch *d);
+extern void uiprivLatencyRecord(uiLatencyKind kind, gint64 microseconds, const char *what);
+
+// watchdog.c
+extern void uiprivInitWatchdog(void);
+extern void uiprivUninitWatchdog(void);
+
+// worker.c
+extern void uiprivUninitWorkers(void);
+
+// draw.c
+extern void uiprivUninitGradientCache(void);
+
 // util.c
 extern void uiprivSetMargined(GtkContainer *, int);
 
@@ -44,6 +91,7 @@ extern GtkWidget *uiprivChildBox(uiprivChild *c);
 extern void uiprivChildSetMargined(uiprivChild *c, int margined);
 
 // draw.c
+// contexts are allocated from the frame arena; they go away when the caller releases the arena
 extern uiDrawContext *uiprivNewContext(cairo_t *cr, GtkStyleContext *style);
 extern void uiprivFreeContext(uiDrawContext *);
 
@@ -59,3 +107,5 @@ extern PangoAttribute *uiprivFUTURE_pango_attr_font_features_new(const gchar *fe
 extern PangoAttribute *uiprivFUTURE_pango_attr_foreground_alpha_new(guint16 alpha);
 extern PangoAttribute *uiprivFUTURE_pango_attr_background_alpha_new(guint16 alpha);
 extern gboolean uiprivFUTURE_gtk_widget_path_iter_set_object_name(GtkWidgetPath *path, gint pos, const char *name);
+extern gboolean uiprivFUTURE_cairo_surface_get_device_scale(cairo_surface_t *surface, double *xScale, double *yScale);
+extern gboolean uiprivFUTURE_cairo_surface_set_device_scale(cairo_surface_t *surface, double xScale, double yScale);
@@ -0,0 +1,154 @@
+// 18 october 2026
+#include "uipriv_unix.h"
+
+// the watchdog is a thread that checks on the main loop every quarter of the threshold
+// the main loop reports in through a GSource that never dispatches: its prepare function runs right before the main loop polls and its check function runs right after, and both bump a counter
+// so if the counter hasn't moved between two checks and the main loop isn't polling, the main thread has been busy the whole time, either dispatching something or off running the program's own code between uiMainStep() calls
+// latency.c publishes which libui dispatch is running, so a stall can be pinned on a particular handler
+// the source has the highest priority there is, because GLib stops preparing sources once it has found a ready one with a higher priority
+
+// both only touched with atomic operations
+// beats is 0 until the main loop has run once, so building the UI before uiMain() doesn't count as a stall
+static gint beats = 0;
+static gint polling = FALSE;
+
+static GSource *beatSource = NULL;
+
+static gboolean beatPrepare(GSource *s, gint *timeout)
+{
+	g_atomic_int_inc(&beats);
+	g_atomic_int_set(&polling, TRUE);
+	*timeout = -1;
+	return FALSE;
+}
+
+static gboolean beatCheck(GSource *s)
+{
+	g_atomic_int_set(&polling, FALSE);
+	g_atomic_int_inc(&beats);
+	return FALSE;
+}
+
+static GSourceFuncs beatFuncs = {
+	.prepare = beatPrepare,
+	.check = beatCheck,
+};
+
+static GThread *thread = NULL;
+// lock protects stopping and is used with cond to wake the thread up to stop
+static GMutex lock;
+static GCond cond;
+static gboolean stopping;
+// these are only changed while the thread isn't running
+static gint64 threshold;
+static void (*onStall)(const char *, double, int, void *);
+static void *onStallData;
+
+static void report(const char *dispatch, gint64 stalled, int ended)
+{
+	double ms;
+
+	ms = (double) stalled / 1000;
+	if (onStall != NULL) {
+		(*onStall)(dispatch, ms, ended, onStallData);
+		return;
+	}
+	if (dispatch == NULL)
+		dispatch = "no libui dispatch (the program's own code, or a GTK+ handler)";
+	if (ended)
+		g_printerr("[libui] watchdog: main loop was stalled for %.0f ms in %s\n", ms, dispatch);
+	else
+		g_printerr("[libui] watchdog: main loop stalled for %.0f ms in %s\n", ms, dispatch);
+}
+
+static gpointer watch(gpointer data)
+{
+	gint last, now;
+	gint64 lastChange, t;
+	gboolean reported;
+	const char *stalledIn;
+
+	last = g_atomic_int_get(&beats);
+	lastChange = g_get_monotonic_time();
+	reported = FALSE;
+	stalledIn = NULL;
+	g_mutex_lock(&lock);
+	while (!stopping) {
+		g_cond_wait_until(&cond, &lock, g_get_monotonic_time() + threshold / 4);
+		if (stopping)
+			break;
+		t = g_get_monotonic_time();
+		now = g_atomic_int_get(&beats);
+		if (now != last || now == 0 || g_atomic_int_get(&polling)) {
+			if (reported)
+				report(stalledIn, t - lastChange, TRUE);
+			reported = FALSE;
+			last = now;
+			lastChange = t;
+			continue;
+		}
+		if (!reported && t - lastChange >= threshold) {
+			// the dispatch strings are all string literals, so they can be read from here no matter what the main thread does next
+			stalledIn = (const char *) g_atomic_pointer_get(&uiprivActiveDispatch);
+			report(stalledIn, t - lastChange, FALSE);
+			reported = TRUE;
+		}
+	}
+	g_mutex_unlock(&lock);
+	return NULL;
+}
+
+void uiWatchdogStart(int thresholdMilliseconds, void (*f)(const char *dispatch, double stalledMilliseconds, int ended, void *data), void *data)
+{
+	if (thresholdMilliseconds <= 0)
+		uiprivUserBug("Invalid threshold %d passed to uiWatchdogStart().", thresholdMilliseconds);
+	uiWatchdogStop();
+	threshold = (gint64) thresholdMilliseconds * 1000;
+	onStall = f;
+	onStallData = data;
+	stopping = FALSE;
+
+	beatSource = g_source_new(&beatFuncs, sizeof (GSource));
+	g_source_set_name(beatSource, "libui watchdog");
+	g_source_set_priority(beatSource, G_PRIORITY_HIGH);
+	g_source_attach(beatSource, NULL);
+	thread = g_thread_new("libui watchdog", watch, NULL);
+}
+
+void uiWatchdogStop(void)
+{
+	if (thread == NULL)
+		return;
+	g_mutex_lock(&lock);
+	stopping = TRUE;
+	g_cond_signal(&cond);
+	g_mutex_unlock(&lock);
+	g_thread_join(thread);
+	thread = NULL;
+
+	g_source_destroy(beatSource);
+	g_source_unref(beatSource);
+	beatSource = NULL;
+	g_atomic_int_set(&beats, 0);
+	g_atomic_int_set(&polling, FALSE);
+}
+
+// setting LIBUI_WATCHDOG to a number of milliseconds starts the watchdog with that threshold, printing stalls to standard error
+void uiprivInitWatchdog(void)
+{
+	const char *env;
+	int ms;
+
+	env = g_getenv("LIBUI_WATCHDOG");
+	if (env == NULL)
+		return;
+	ms = atoi(env);
+	if (ms <= 0)
+		return;
+	uiWatchdogStart(ms, NULL, NULL);
+}
+
+void uiprivUninitWatchdog(void)
+{
+	uiWatchdogStop();
+}
@@ -43,9 +43,14 @@ struct uiWindow {
 static gboolean onClosing(GtkWidget *win, GdkEvent *e, gpointer data)
 {
 	uiWindow *w = uiWindow(data);
+	uiprivDispatch dispatch;
+	int destroy;
 
+	uiprivDispatchBegin(&dispatch, uiLatencyKindControlEvent, "uiWindow OnClosing");
+	destroy = (*(w->onClosing))(w, w->onClosingData);
+	uiprivDispatchEnd(&dispatch);
 	// manually destroy the window ourselves; don't let the delete-event handler do it
-	if ((*(w->onClosing))(w, w->onClosingData))
+	if (destroy)
 		uiControlDestroy(uiControl(w));
 	// don't continue to the default delete-event handler; we destroyed the window by now
 	return TRUE;
@@ -55,14 +60,18 @@ static void onSizeAllocate(GtkWidget *widget, GdkRectangle *allocation, gpointer
 {
 	int width, height;
 	uiWindow *w = uiWindow(data);
+	uiprivDispatch dispatch;
 
 	// Ignore spurious size-allocate events
 	uiWindowContentSize(w, &width, &height);
 	if (width != w->cachedWidth || height != w->cachedHeight) {
 		w->cachedWidth = width;
 		w->cachedHeight = height;
-		if (!w->changingSize)
+		if (!w->changingSize) {
+			uiprivDispatchBegin(&dispatch, uiLatencyKindControlEvent, "uiWindow OnContentSizeChanged");
 			(*(w->onContentSizeChanged))(w, w->onContentSizeChangedData);
+			uiprivDispatchEnd(&dispatch);
+		}
 	}
 
 	if (w->changingSize)
@@ -72,22 +81,29 @@ static void onSizeAllocate(GtkWidget *widget, GdkRectangle *allocation, gpointer
 static gboolean onGetFocus(GtkWidget *win, GdkEvent *e, gpointer data)
 {
 	uiWindow *w = uiWindow(data);
+	uiprivDispatch dispatch;
 	w->focused = 1;
+	uiprivDispatchBegin(&dispatch, uiLatencyKindControlEvent, "uiWindow OnFocusChanged");
 	w->onFocusChanged(w, w->onFocusChangedData);
+	uiprivDispatchEnd(&dispatch);
 	return FALSE;
 }
 
 static gboolean onLoseFocus(GtkWidget *win, GdkEvent *e, gpointer data)
 {
 	uiWindow *w = uiWindow(data);
+	uiprivDispatch dispatch;
 	w->focused = 0;
+	uiprivDispatchBegin(&dispatch, uiLatencyKindControlEvent, "uiWindow OnFocusChanged");
 	w->onFocusChanged(w, w->onFocusChangedData);
+	uiprivDispatchEnd(&dispatch);
 	return FALSE;
 }
 
 static gboolean onConfigure(GtkWidget *win, GdkEvent *e, gpointer data)
 {
 	uiWindow *w = uiWindow(data);
+	uiprivDispatch dispatch;
 
 	int x, y;
 
@@ -96,8 +112,11 @@ static gboolean onConfigure(GtkWidget *win, GdkEvent *e, gpointer data)
 	if (x != w->cachedPosX || y != w->cachedPosY) {
 		w->cachedPosX = x;
 		w->cachedPosY = y;
-		if (!w->changingPosition)
+		if (!w->changingPosition) {
+			uiprivDispatchBegin(&dispatch, uiLatencyKindControlEvent, "uiWindow OnPositionChanged");
 			(*(w->onPositionChanged))(w, w->onPositionChangedData);
+			uiprivDispatchEnd(&dispatch);
+		}
 	}
 
 	if (w->changingPosition)
@@ -0,0 +1,269 @@
+// 18 october 2026
+#include "uipriv_unix.h"
+
+// the worker pool is a set of threads, one per processor, started the first time uiWorkerSubmit() is called
+// every worker has its own deque of jobs; a worker takes jobs from the back of its own deque and, when that runs dry, steals from the front of the others, so a worker that is stuck on a long job doesn't hold up the jobs behind it
+// jobs submitted from a worker go on that worker's own deque, which keeps jobs that split themselves up on the same thread; jobs submitted from anywhere else are dealt out to the workers in turn
+// workers with nothing to do sleep on a condition variable until a job is submitted
+// finished jobs are collected in one list, and the main thread runs their completion callbacks in batches from a single uiQueueMain() call
+
+struct uiCancelToken {
+	// only touched with atomic operations
+	gint refcount;
+	gint cancelled;
+};
+
+struct job {
+	void (*work)(uiCancelToken *, void *);
+	void (*done)(int, void *);
+	void *data;
+	uiCancelToken *token;
+};
+
+struct worker {
+	GThread *thread;
+	// lock protects jobs
+	GMutex lock;
+	GQueue jobs;
+};
+
+// workers is only set once the pool is ready to take jobs; startLock keeps two threads from starting it at once
+static struct worker *workers = NULL;
+static guint nWorkers = 0;
+static GMutex startLock;
+// the index of the worker a thread is, plus one, so that 0 means the thread isn't a worker
+static GPrivate workerIndex;
+static guint nextWorker = 0;
+
+// the number of jobs waiting in deques; only touched with atomic operations
+static gint queued = 0;
+// sleepLock orders sleeping against submitting; see takeJob()
+static GMutex sleepLock;
+static GCond sleepCond;
+// only touched with atomic operations
+static gint quitting = FALSE;
+
+// finishedLock protects finished
+static GMutex finishedLock;
+static GQueue finished = G_QUEUE_INIT;
+
+uiCancelToken *uiNewCancelToken(void)
+{
+	uiCancelToken *t;
+
+	t = uiprivNew(uiCancelToken);
+	t->refcount = 1;
+	return t;
+}
+
+static uiCancelToken *refToken(uiCancelToken *t)
+{
+	if (t != NULL)
+		g_atomic_int_inc(&(t->refcount));
+	return t;
+}
+
+static void unrefToken(uiCancelToken *t)
+{
+	if (t != NULL && g_atomic_int_dec_and_test(&(t->refcount)))
+		uiprivFree(t);
+}
+
+void uiFreeCancelToken(uiCancelToken *t)
+{
+	// jobs that were submitted with the token keep it alive until they're done
+	unrefToken(t);
+}
+
+void uiCancelTokenCancel(uiCancelToken *t)
+{
+	g_atomic_int_set(&(t->cancelled), 1);
+}
+
+int uiCancelTokenCancelled(uiCancelToken *t)
+{
+	if (t == NULL)
+		return 0;
+	return g_atomic_int_get(&(t->cancelled));
+}
+
+static void freeJob(struct job *j)
+{
+	unrefToken(j->token);
+	uiprivPoolDelete(struct job, j);
+}
+
+static void runFinished(void *data)
+{
+	GQueue batch = G_QUEUE_INIT;
+	struct job *j;
+
+	// take the whole list at once, so the workers aren't held up by the callbacks
+	g_mutex_lock(&finishedLock);
+	batch = finished;
+	g_queue_init(&finished);
+	g_mutex_unlock(&finishedLock);
+	while ((j = (struct job *) g_queue_pop_head(&batch)) != NULL) {
+		// check the token here rather than on the worker, so that cancelling from the main thread after the work is done still counts
+		if (j->done != NULL)
+			(*(j->done))(uiCancelTokenCancelled(j->token), j->data);
+		freeJob(j);
+	}
+}
+
+static void finishJob(struct job *j)
+{
+	gboolean wasEmpty;
+
+	g_mutex_lock(&finishedLock);
+	wasEmpty = g_queue_is_empty(&finished);
+	g_queue_push_tail(&finished, j);
+	g_mutex_unlock(&finishedLock);
+	// if the list wasn't empty, a runFinished() is already queued
+	if (wasEmpty)
+		uiQueueMain(runFinished, NULL);
+}
+
+static struct job *popJob(struct worker *w, gboolean own)
+{
+	struct job *j;
+
+	g_mutex_lock(&(w->lock));
+	if (own)
+		j = (struct job *) g_queue_pop_tail(&(w->jobs));
+	else
+		j = (struct job *) g_queue_pop_head(&(w->jobs));
+	g_mutex_unlock(&(w->lock));
+	if (j != NULL)
+		g_atomic_int_add(&queued, -1);
+	return j;
+}
+
+static struct job *takeJob(guint self)
+{
+	struct job *j;
+	guint i;
+
+	for (;;) {
+		if (g_atomic_int_get(&quitting))
+			return NULL;
+		j = popJob(&workers[self], TRUE);
+		if (j != NULL)
+			return j;
+		for (i = 1; i < nWorkers; i++) {
+			j = popJob(&workers[(self + i) % nWorkers], FALSE);
+			if (j != NULL)
+				return j;
+		}
+		// submitters bump queued before they take sleepLock to signal, and we only wait after seeing queued at 0 with sleepLock held, so no wakeup can be missed
+		g_mutex_lock(&sleepLock);
+		while (!g_atomic_int_get(&quitting) && g_atomic_int_get(&queued) == 0)
+			g_cond_wait(&sleepCond, &sleepLock);
+		g_mutex_unlock(&sleepLock);
+	}
+}
+
+static gpointer workerThread(gpointer data)
+{
+	guint self = GPOINTER_TO_UINT(data);
+	struct job *j;
+
+	g_private_set(&workerIndex, GUINT_TO_POINTER(self + 1));
+	while ((j = takeJob(self)) != NULL) {
+		if (!uiCancelTokenCancelled(j->token))
+			(*(j->work))(j->token, j->data);
+		finishJob(j);
+	}
+	return NULL;
+}
+
+static void startWorkers(void)
+{
+	struct worker *w;
+	char name[32];
+	guint i;
+
+	g_mutex_lock(&startLock);
+	if (workers != NULL) {
+		g_mutex_unlock(&startLock);
+		return;
+	}
+	nWorkers = g_get_num_processors();
+	w = g_new0(struct worker, nWorkers);
+	for (i = 0; i < nWorkers; i++) {
+		g_mutex_init(&(w[i].lock));
+		g_queue_init(&(w[i].jobs));
+	}
+	// the workers steal from each other as soon as they start, so every deque has to be ready first
+	g_atomic_pointer_set(&workers, w);
+	for (i = 0; i < nWorkers; i++) {
+		g_snprintf(name, 32, "libui worker %u", i);
+		w[i].thread = g_thread_new(name, workerThread, GUINT_TO_POINTER(i));
+	}
+	g_mutex_unlock(&startLock);
+}
+
+// called by uiUninit(), before the main thread queue goes away
+void uiprivUninitWorkers(void)
+{
+	struct job *j;
+	guint i;
+
+	if (workers == NULL)
+		return;
+	g_mutex_lock(&sleepLock);
+	g_atomic_int_set(&quitting, TRUE);
+	g_cond_broadcast(&sleepCond);
+	g_mutex_unlock(&sleepLock);
+	// jobs that are running are allowed to finish; jobs that haven't started are dropped without calling their completion callbacks, just like anything else still queued for the main thread
+	for (i = 0; i < nWorkers; i++)
+		g_thread_join(workers[i].thread);
+	for (i = 0; i < nWorkers; i++) {
+		while ((j = (struct job *) g_queue_pop_head(&(workers[i].jobs))) != NULL)
+			freeJob(j);
+		g_mutex_clear(&(workers[i].lock));
+	}
+	while ((j = (struct job *) g_queue_pop_head(&finished)) != NULL)
+		freeJob(j);
+	g_free(workers);
+	g_atomic_pointer_set(&workers, NULL);
+	nWorkers = 0;
+	nextWorker = 0;
+	queued = 0;
+	quitting = FALSE;
+}
+
+void uiWorkerSubmit(uiCancelToken *t, void (*work)(uiCancelToken *t, void *data), void (*done)(int cancelled, void *data), void *data)
+{
+	struct job *j;
+	struct worker *w;
+	guint self;
+
+	if (g_atomic_pointer_get(&workers) == NULL)
+		startWorkers();
+	j = uiprivPoolNew(struct job);
+	j->work = work;
+	j->done = done;
+	j->data = data;
+	j->token = refToken(t);
+
+	self = GPOINTER_TO_UINT(g_private_get(&workerIndex));
+	if (self != 0)
+		w = &workers[self - 1];
+	else
+		w = &workers[((guint) g_atomic_int_add((gint *) (&nextWorker), 1)) % nWorkers];
+	// count the job before it can be taken, so queued never goes negative; a worker that sees it too early just looks again
+	g_atomic_int_inc(&queued);
+	g_mutex_lock(&(w->lock));
+	g_queue_push_tail(&(w->jobs), j);
+	g_mutex_unlock(&(w->lock));
+
+	g_mutex_lock(&sleepLock);
+	g_cond_signal(&sleepCond);
+	g_mutex_unlock(&sleepLock);
+}
+
+int uiWorkerQueueDepth(void)
+{
+	return g_atomic_int_get(&queued);
+}
@@ -62,3 +62,33 @@ void uiprivFree(void *_p)
 	delete heap[p];
 	heap.erase(p);
 }
+
+// TODO size-class pools like on Unix
+void *uiprivPoolAlloc(size_t size, const char *type)
+{
+	return uiprivAlloc(size, type);
+}
+
+void uiprivPoolFree(void *p, size_t size)
+{
+	uiprivFree(p);
+}
+
+int uiMemoryNumPools(void)
+{
+	return 0;
+}
+
+void uiMemoryGetPoolStats(int n, uiMemoryPoolStats *s)
+{
+	uiprivUserBug("Invalid pool index %d passed to uiMemoryGetPoolStats(); there are no pools on this platform.", n);
+}
+
+// TODO per-type statistics are only kept on Unix for now
+void uiMemoryStatsForEach(uiMemoryStatsForEachFunc f, void *data)
+{
+}
+
+void uiMemoryDumpStats(void)
+{
+}
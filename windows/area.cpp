@@ -51,7 +51,16 @@ static LRESULT CALLBACK areaWndProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM
 
 // control implementation
 
-uiWindowsControlAllDefaults(uiArea)
+static void uiAreaDestroy(uiControl *c)
+{
+	uiArea *a = uiArea(c);
+
+	uiAreaOnFrame(a, NULL, NULL);
+	uiWindowsEnsureDestroyWindow(a->hwnd);
+	uiFreeControl(uiControl(a));
+}
+
+uiWindowsControlAllDefaultsExceptDestroy(uiArea)
 
 static void uiAreaMinimumSize(uiWindowsControl *c, int *width, int *height)
 {
@@ -95,6 +104,50 @@ void uiAreaQueueRedrawAll(uiArea *a)
 	invalidateRect(a->hwnd, NULL, FALSE);
 }
 
+// TODO redraw only the rectangles like the Unix version does
+void uiAreaQueueRedrawRect(uiArea *a, double x, double y, double width, double height)
+{
+	uiAreaQueueRedrawAll(a);
+}
+
+void uiAreaQueueRedrawRects(uiArea *a, const uiAreaRect *rects, int n)
+{
+	uiAreaQueueRedrawAll(a);
+}
+
+// TODO drive this from the display's refresh like the Unix version does
+static int areaFrame(void *data)
+{
+	uiArea *a = (uiArea *) data;
+	uiTimerID timer;
+	double t;
+
+	timer = a->frameTimer;
+	t = (double) (a->frames++) * (1000.0 / 60);
+	if ((*(a->onFrame))(a, t, t, a->onFrameData))
+		// if the callback called uiAreaOnFrame() itself, this timer is no longer the area's
+		return a->frameTimer == timer;
+	if (a->frameTimer == timer) {
+		a->frameTimer = 0;
+		a->onFrame = NULL;
+		a->onFrameData = NULL;
+	}
+	return 0;
+}
+
+void uiAreaOnFrame(uiArea *a, int (*f)(uiArea *a, double frameTime, double presentationTime, void *data), void *data)
+{
+	if (a->frameTimer != 0)
+		uiTimerCancel(a->frameTimer);
+	a->frameTimer = 0;
+	a->onFrame = f;
+	a->onFrameData = data;
+	if (f == NULL)
+		return;
+	a->frames = 0;
+	a->frameTimer = uiTimerStart(1000.0 / 60, uiTimerModeFixedRate, areaFrame, a);
+}
+
 void uiAreaScrollTo(uiArea *a, double x, double y, double width, double height)
 {
 	// TODO
@@ -26,6 +26,12 @@ struct uiArea {
 	BOOL tracking;
 
 	ID2D1HwndRenderTarget *rt;
+
+	// for uiAreaOnFrame()
+	int (*onFrame)(uiArea *, double, double, void *);
+	void *onFrameData;
+	uiTimerID frameTimer;
+	int frames;
 };
 
 // areadraw.cpp
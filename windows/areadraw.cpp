@@ -6,6 +6,7 @@ static HRESULT doPaint(uiArea *a, ID2D1RenderTarget *rt, RECT *clip)
 {
 	uiAreaHandler *ah = a->ah;
 	uiAreaDrawParams dp;
+	uiAreaRect damage;
 	COLORREF bgcolorref;
 	D2D1_COLOR_F bgcolor;
 	D2D1_MATRIX_3X2_F scrollTransform;
@@ -23,6 +24,13 @@ static HRESULT doPaint(uiArea *a, ID2D1RenderTarget *rt, RECT *clip)
 		dp.ClipX += a->hscrollpos;
 		dp.ClipY += a->vscrollpos;
 	}
+	// TODO pass the individual rectangles of the update region like the Unix version does
+	damage.X = dp.ClipX;
+	damage.Y = dp.ClipY;
+	damage.Width = dp.ClipWidth;
+	damage.Height = dp.ClipHeight;
+	dp.DamageRects = &damage;
+	dp.NumDamageRects = 1;
 
 	rt->BeginDraw();
 
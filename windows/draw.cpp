@@ -415,6 +415,41 @@ void uiDrawFill(uiDrawContext *c, uiDrawPath *p, uiDrawBrush *b)
 	brush->Release();
 }
 
+// TODO cache the Direct2D brush like the Unix version does
+struct uiDrawCachedBrush {
+	uiDrawBrush b;
+};
+
+uiDrawCachedBrush *uiDrawNewCachedBrush(uiDrawBrush *b)
+{
+	uiDrawCachedBrush *cb;
+
+	cb = uiprivNew(uiDrawCachedBrush);
+	cb->b = *b;
+	if (b->NumStops != 0) {
+		cb->b.Stops = (uiDrawBrushGradientStop *) uiprivAlloc(b->NumStops * sizeof (uiDrawBrushGradientStop), "uiDrawBrushGradientStop[]");
+		memcpy(cb->b.Stops, b->Stops, b->NumStops * sizeof (uiDrawBrushGradientStop));
+	}
+	return cb;
+}
+
+void uiDrawFreeCachedBrush(uiDrawCachedBrush *cb)
+{
+	if (cb->b.NumStops != 0)
+		uiprivFree(cb->b.Stops);
+	uiprivFree(cb);
+}
+
+void uiDrawCachedBrushFill(uiDrawContext *c, uiDrawPath *path, uiDrawCachedBrush *cb)
+{
+	uiDrawFill(c, path, &(cb->b));
+}
+
+void uiDrawCachedBrushStroke(uiDrawContext *c, uiDrawPath *path, uiDrawCachedBrush *cb, uiDrawStrokeParams *p)
+{
+	uiDrawStroke(c, path, &(cb->b), p);
+}
+
 void uiDrawTransform(uiDrawContext *c, uiDrawMatrix *m)
 {
 	D2D1_MATRIX_3X2_F dm, cur;
@@ -518,6 +553,52 @@ void uiDrawRestore(uiDrawContext *c)
 	c->currentClip = state.clip;
 }
 
+// TODO test against the damage like the Unix version does
+int uiDrawIntersectsDamage(uiDrawContext *c, double x, double y, double width, double height)
+{
+	return 1;
+}
+
+// TODO keep layer contents like the Unix version does
+struct uiDrawLayer {
+	int unused;
+};
+
+uiDrawLayer *uiDrawNewLayer(double width, double height)
+{
+	return uiprivNew(uiDrawLayer);
+}
+
+void uiDrawFreeLayer(uiDrawLayer *l)
+{
+	uiprivFree(l);
+}
+
+int uiDrawLayerValid(uiDrawContext *c, uiDrawLayer *l)
+{
+	return 0;
+}
+
+void uiDrawLayerInvalidate(uiDrawLayer *l)
+{
+	// do nothing
+}
+
+void uiDrawLayerBegin(uiDrawContext *c, uiDrawLayer *l)
+{
+	// do nothing
+}
+
+void uiDrawLayerEnd(uiDrawContext *c, uiDrawLayer *l)
+{
+	// do nothing
+}
+
+void uiDrawLayerDraw(uiDrawContext *c, uiDrawLayer *l, uiDrawMatrix *m, double opacity)
+{
+	// do nothing
+}
+
 
 // bitmap API
 
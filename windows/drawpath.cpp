@@ -10,21 +10,20 @@ struct uiDrawPath {
 	ID2D1PathGeometry *path;
 	ID2D1GeometrySink *sink;
 	BOOL inFigure;
+	uiDrawFillMode fillMode;
 };
 
-uiDrawPath *uiDrawNewPath(uiDrawFillMode fillmode)
+static void openPath(uiDrawPath *p)
 {
-	uiDrawPath *p;
 	HRESULT hr;
 
-	p = uiprivNew(uiDrawPath);
 	hr = d2dfactory->CreatePathGeometry(&(p->path));
 	if (hr != S_OK)
 		logHRESULT(L"error creating path", hr);
 	hr = p->path->Open(&(p->sink));
 	if (hr != S_OK)
 		logHRESULT(L"error opening path", hr);
-	switch (fillmode) {
+	switch (p->fillMode) {
 	case uiDrawFillModeWinding:
 		p->sink->SetFillMode(D2D1_FILL_MODE_WINDING);
 		break;
@@ -32,20 +31,49 @@ uiDrawPath *uiDrawNewPath(uiDrawFillMode fillmode)
 		p->sink->SetFillMode(D2D1_FILL_MODE_ALTERNATE);
 		break;
 	}
-	return p;
 }
 
-void uiDrawFreePath(uiDrawPath *p)
+static void closePath(uiDrawPath *p)
 {
 	if (p->inFigure)
 		p->sink->EndFigure(D2D1_FIGURE_END_OPEN);
+	p->inFigure = FALSE;
 	if (p->sink != NULL)
 		// TODO close sink first?
 		p->sink->Release();
+	p->sink = NULL;
 	p->path->Release();
+	p->path = NULL;
+}
+
+uiDrawPath *uiDrawNewPath(uiDrawFillMode fillmode)
+{
+	uiDrawPath *p;
+
+	p = uiprivNew(uiDrawPath);
+	p->fillMode = fillmode;
+	openPath(p);
+	return p;
+}
+
+void uiDrawFreePath(uiDrawPath *p)
+{
+	closePath(p);
 	uiprivFree(p);
 }
 
+void uiDrawPathReset(uiDrawPath *p)
+{
+	// TODO keep the memory like the Unix version does; a path geometry can only be opened once, so this needs a new one
+	closePath(p);
+	openPath(p);
+}
+
+void uiDrawPathReserve(uiDrawPath *p, int n)
+{
+	// do nothing; Direct2D has no way to reserve space in a path geometry
+}
+
 void uiDrawPathNewFigure(uiDrawPath *p, double x, double y)
 {
 	D2D1_POINT_2F pt;
@@ -243,6 +271,45 @@ void uiDrawPathAddRectangle(uiDrawPath *p, double x, double y, double width, dou
 	uiDrawPathCloseFigure(p);
 }
 
+// TODO feed these to Direct2D in bulk like the Unix version does
+
+void uiDrawPathAddPolyline(uiDrawPath *p, const double *xy, int n)
+{
+	int i;
+
+	if (n <= 0)
+		return;
+	uiDrawPathNewFigure(p, xy[0], xy[1]);
+	for (i = 1; i < n; i++)
+		uiDrawPathLineTo(p, xy[2 * i], xy[2 * i + 1]);
+}
+
+void uiDrawPathAddPolygon(uiDrawPath *p, const double *xy, int n)
+{
+	if (n <= 0)
+		return;
+	uiDrawPathAddPolyline(p, xy, n);
+	uiDrawPathCloseFigure(p);
+}
+
+void uiDrawPathAddRectangles(uiDrawPath *p, const double *xywh, int n)
+{
+	int i;
+
+	for (i = 0; i < n; i++)
+		uiDrawPathAddRectangle(p, xywh[4 * i], xywh[4 * i + 1], xywh[4 * i + 2], xywh[4 * i + 3]);
+}
+
+void uiDrawPathAddCircles(uiDrawPath *p, const double *xyr, int n)
+{
+	int i;
+
+	for (i = 0; i < n; i++) {
+		uiDrawPathNewFigureWithArc(p, xyr[3 * i], xyr[3 * i + 1], xyr[3 * i + 2], 0, 2 * uiPi, 0);
+		uiDrawPathCloseFigure(p);
+	}
+}
+
 void uiDrawPathEnd(uiDrawPath *p)
 {
 	HRESULT hr;
@@ -140,6 +140,7 @@ const char *uiInit(uiInitOptions *o)
 
 void uiUninit(void)
 {
+	uiprivUninitWorkers();
 	uiprivUninitTimers();
 	uiprivUninitImage();
 	uninitMenus();
@@ -129,6 +129,18 @@ void uiQueueMain(void (*f)(void *data), void *data)
 		logLastError(L"error queueing function to run on main thread");
 }
 
+// TODO map priorities onto the native message loop like the Unix version does
+void uiQueueMainWithPriority(uiQueuePriority priority, void (*f)(void *data), void *data)
+{
+	uiQueueMain(f, data);
+}
+
+// TODO coalesce calls with the same key like the Unix version does
+void uiQueueMainKeyed(const void *key, void (*f)(void *data), void *data, void (*freeData)(void *data))
+{
+	uiQueueMain(f, data);
+}
+
 static std::map<uiprivTimer *, bool> timers;
 
 void uiTimer(int milliseconds, int (*f)(void *data), void *data)
@@ -158,3 +170,276 @@ void uiprivUninitTimers(void)
 		uiprivFree(t->first);
 	timers.clear();
 }
+
+// TODO implement the fixed-rate modes and share one native timer like the Unix version does
+struct timerHandle {
+	uiTimerID id;
+	int (*f)(void *);
+	void *data;
+	int cancelled;
+	struct timerHandle *next;
+};
+
+static struct timerHandle *timerHandles = NULL;
+static uiTimerID nextTimerID = 1;
+
+static struct timerHandle *findTimerHandle(uiTimerID id)
+{
+	struct timerHandle *h;
+
+	for (h = timerHandles; h != NULL; h = h->next)
+		if (h->id == id && !h->cancelled)
+			return h;
+	return NULL;
+}
+
+static int timerHandleTick(void *data)
+{
+	struct timerHandle *h = (struct timerHandle *) data;
+	struct timerHandle **p;
+
+	if (!h->cancelled && !(*(h->f))(h->data))
+		h->cancelled = 1;
+	if (!h->cancelled)
+		return 1;
+	for (p = &timerHandles; *p != h; p = &((*p)->next))
+		;
+	*p = h->next;
+	delete h;
+	return 0;
+}
+
+// these are new'd rather than uiprivNew()'d because a cancelled timer is only freed on its next tick, which might not come before uiUninit()
+static void startTimerHandle(uiTimerID id, double milliseconds, int (*f)(void *), void *data)
+{
+	struct timerHandle *h;
+
+	h = new timerHandle;
+	h->id = id;
+	h->f = f;
+	h->data = data;
+	h->cancelled = 0;
+	h->next = timerHandles;
+	timerHandles = h;
+	uiTimer((int) milliseconds, timerHandleTick, h);
+}
+
+uiTimerID uiTimerStart(double milliseconds, uiTimerMode mode, int (*f)(void *data), void *data)
+{
+	if (nextTimerID == 0)
+		nextTimerID++;
+	startTimerHandle(nextTimerID, milliseconds, f, data);
+	return nextTimerID++;
+}
+
+void uiTimerCancel(uiTimerID id)
+{
+	struct timerHandle *h;
+
+	h = findTimerHandle(id);
+	if (h != NULL)
+		h->cancelled = 1;
+}
+
+void uiTimerReschedule(uiTimerID id, double milliseconds)
+{
+	struct timerHandle *h;
+
+	h = findTimerHandle(id);
+	if (h == NULL)
+		return;
+	h->cancelled = 1;
+	startTimerHandle(id, milliseconds, h->f, h->data);
+}
+
+// TODO enforce a time budget like the Unix version does
+void uiScheduleWork(int (*f)(void *data), void *data)
+{
+	uiTimer(1, f, data);
+}
+
+void uiSchedulerSetBudget(int budgetMicroseconds, int periodMicroseconds)
+{
+	// do nothing
+}
+
+void uiSchedulerGetStats(uiSchedulerStats *stats)
+{
+	ZeroMemory(stats, sizeof (uiSchedulerStats));
+}
+
+// jobs run on the Windows thread pool, through a cleanup group so uiUninit() can wait for the ones that are running
+// unlike the Unix version, the system pool has no per-thread deques for us to steal from; it balances the work itself
+// these are new'd rather than uiprivNew()'d because they are freed on the pool's threads, and because a completion that is still queued when uiUninit() is called is never run, and so never frees what it holds
+
+struct uiCancelToken {
+	// only touched with Interlocked functions
+	LONG refcount;
+	LONG cancelled;
+};
+
+struct workerJob {
+	uiCancelToken *t;
+	void (*work)(uiCancelToken *, void *);
+	void (*done)(int, void *);
+	void *data;
+};
+
+// the environment and group are made by the first uiWorkerSubmit() after uiInit(); workerLock keeps two threads from making them at once
+static SRWLOCK workerLock = SRWLOCK_INIT;
+static TP_CALLBACK_ENVIRON workerEnv;
+static PTP_CLEANUP_GROUP workerGroup = NULL;
+// only touched with Interlocked functions
+static LONG queued = 0;
+static LONG quitting = 0;
+
+uiCancelToken *uiNewCancelToken(void)
+{
+	uiCancelToken *t;
+
+	t = new uiCancelToken;
+	t->refcount = 1;
+	t->cancelled = 0;
+	return t;
+}
+
+static void unrefToken(uiCancelToken *t)
+{
+	if (t != NULL && InterlockedDecrement(&(t->refcount)) == 0)
+		delete t;
+}
+
+void uiFreeCancelToken(uiCancelToken *t)
+{
+	// jobs that were submitted with the token keep it alive until they're done
+	unrefToken(t);
+}
+
+void uiCancelTokenCancel(uiCancelToken *t)
+{
+	InterlockedExchange(&(t->cancelled), 1);
+}
+
+int uiCancelTokenCancelled(uiCancelToken *t)
+{
+	if (t == NULL)
+		return 0;
+	return InterlockedCompareExchange(&(t->cancelled), 0, 0) != 0;
+}
+
+static void freeJob(struct workerJob *j)
+{
+	unrefToken(j->t);
+	delete j;
+}
+
+static void workerRunDone(void *data)
+{
+	struct workerJob *j = (struct workerJob *) data;
+
+	// check the token here rather than on the worker, so that cancelling from the main thread after the work is done still counts
+	if (j->done != NULL)
+		(*(j->done))(uiCancelTokenCancelled(j->t), j->data);
+	freeJob(j);
+}
+
+static void CALLBACK workerRun(PTP_CALLBACK_INSTANCE instance, PVOID data)
+{
+	struct workerJob *j = (struct workerJob *) data;
+
+	InterlockedDecrement(&queued);
+	// jobs that haven't started by uiUninit() are dropped without calling their completion callbacks, like on Unix
+	if (InterlockedCompareExchange(&quitting, 0, 0) != 0) {
+		freeJob(j);
+		return;
+	}
+	if (!uiCancelTokenCancelled(j->t))
+		(*(j->work))(j->t, j->data);
+	uiQueueMain(workerRunDone, j);
+}
+
+void uiWorkerSubmit(uiCancelToken *t, void (*work)(uiCancelToken *t, void *data), void (*done)(int cancelled, void *data), void *data)
+{
+	struct workerJob *j;
+
+	AcquireSRWLockExclusive(&workerLock);
+	if (workerGroup == NULL) {
+		workerGroup = CreateThreadpoolCleanupGroup();
+		if (workerGroup == NULL) {
+			ReleaseSRWLockExclusive(&workerLock);
+			logLastError(L"error creating worker cleanup group");
+			return;
+		}
+		InitializeThreadpoolEnvironment(&workerEnv);
+		SetThreadpoolCallbackCleanupGroup(&workerEnv, workerGroup, NULL);
+	}
+	ReleaseSRWLockExclusive(&workerLock);
+
+	j = new workerJob;
+	j->t = t;
+	if (t != NULL)
+		InterlockedIncrement(&(t->refcount));
+	j->work = work;
+	j->done = done;
+	j->data = data;
+	InterlockedIncrement(&queued);
+	if (TrySubmitThreadpoolCallback(workerRun, j, &workerEnv) == 0) {
+		InterlockedDecrement(&queued);
+		freeJob(j);
+		logLastError(L"error submitting worker job");
+	}
+}
+
+int uiWorkerQueueDepth(void)
+{
+	return (int) InterlockedCompareExchange(&queued, 0, 0);
+}
+
+// called by uiUninit(), before the main thread queue goes away
+void uiprivUninitWorkers(void)
+{
+	if (workerGroup == NULL)
+		return;
+	InterlockedExchange(&quitting, 1);
+	// jobs that are running are allowed to finish; the rest see quitting and free themselves
+	CloseThreadpoolCleanupGroupMembers(workerGroup, FALSE, NULL);
+	CloseThreadpoolCleanupGroup(workerGroup);
+	DestroyThreadpoolEnvironment(&workerEnv);
+	workerGroup = NULL;
+	queued = 0;
+	quitting = 0;
+}
+
+// TODO record latencies like the Unix version does
+void uiLatencyEnable(int enable)
+{
+	// do nothing
+}
+
+void uiLatencyGetHistogram(uiLatencyKind kind, uiLatencyHistogram *h)
+{
+	ZeroMemory(h, sizeof (uiLatencyHistogram));
+}
+
+void uiLatencyReset(void)
+{
+	// do nothing
+}
+
+void uiLatencyDump(void)
+{
+	// do nothing
+}
+
+// TODO watch the main loop like the Unix version does
+void uiWatchdogStart(int thresholdMilliseconds, void (*f)(const char *dispatch, double stalledMilliseconds, int ended, void *data), void *data)
+{
+	if (thresholdMilliseconds <= 0)
+		uiprivUserBug("Invalid threshold %d passed to uiWatchdogStart().", thresholdMilliseconds);
+	// otherwise do nothing
+}
+
+void uiWatchdogStop(void)
+{
+	// do nothing
+}
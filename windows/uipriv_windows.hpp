@@ -107,6 +107,7 @@ extern int registerMessageFilter(void);
 extern void unregisterMessageFilter(void);
 extern void uiprivFreeTimer(uiprivTimer *t);
 extern void uiprivUninitTimers(void);
+extern void uiprivUninitWorkers(void);
 
 // parent.cpp
 extern BOOL handleParentMessages(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam, LRESULT *lResult);